@@ -0,0 +1,224 @@
+/**
+ * @file AutoTune.cpp
+ * Tuning of sieve parameters for this machine.
+ * For every count of digits, random semiprimes are factorized with different parameters:
+ * every parameter in turn is changed while it makes factorization faster (coordinate descent).
+ * Every time is median of several runs, and runs go after untimed warm-up.
+ * The fastest rows are written to parameter table file, which is read by program at start.
+ *
+ * Usage: AutoTune [output file] [numbers for every size] [digits...]
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 18.12.2017
+ * @version 1.0
+ */
+#include <QuadraticSieve/QuadraticSieve.h>
+#include <ParameterTable/ParameterTable.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gmpxx.h>
+
+namespace {
+
+  using Parameters = ParameterTable::Parameters;
+
+  const char defaultOutput[] = "parameters.txt";
+  const uint32_t defaultNumbers = 3;
+  const uint32_t defaultDigits[] = {14, 18, 24, 30, 40, 50};
+
+  // The same corpus for every run, so tables from different runs are comparable
+  const unsigned long corpusSeed = 2017;
+
+  // New parameters are taken only if they are faster at least by this factor, because of noise
+  const double minGain = 0.97;
+  const uint32_t maxPasses = 2;
+  const uint32_t measureRuns = 3;
+
+  const uint32_t minHalfInterval = 4096;
+
+  // Product of two random primes, which have about digits / 2 digits.
+  // Product has as many digits, as sieve counts for row lookup.
+  std::vector<mpz_class> semiprimes(uint32_t digits, uint32_t count, gmp_randclass &random) {
+    std::vector<mpz_class> result;
+
+    while (result.size() < count) {
+      mpz_class n = 1;
+      for (const uint32_t size: {digits / 2, digits - digits / 2}) {
+        mpz_class low;
+        mpz_ui_pow_ui(low.get_mpz_t(), 10, size - 1);
+
+        mpz_class p = random.get_z_range(9 * low) + low;
+        mpz_nextprime(p.get_mpz_t(), p.get_mpz_t());
+        n *= p;
+      }
+
+      if (mpz_sizeinbase(n.get_mpz_t(), 10) == digits)
+        result.emplace_back(n);
+    }
+
+    return result;
+  }
+
+  // Table, where row for row.digits is replaced or inserted
+  std::vector<Parameters> withRow(std::vector<Parameters> rows, const Parameters &row) {
+    const auto it = std::lower_bound(rows.begin(), rows.end(), row, [](const Parameters &a, const Parameters &b) {
+      return a.digits < b.digits;
+    });
+
+    if (it != rows.end() && it->digits == row.digits) {
+      *it = row;
+    } else {
+      rows.insert(it, row);
+    }
+
+    return rows;
+  }
+
+  // Time of factorization of all numbers with current table, infinity if some of them wasn't factorized
+  double run(const std::vector<mpz_class> &numbers) {
+    // New sieve for every run, so found factors aren't reused between runs
+    QuadraticSieve sieve;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (const auto &n: numbers) {
+      const mpz_class factor = sieve.factorNumber(n);
+      if (factor <= 1 || factor >= n || n % factor != 0)
+        return std::numeric_limits<double>::infinity();
+    }
+
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Median time of measureRuns runs with row in table
+  double measure(const std::vector<Parameters> &rows, const Parameters &row, const std::vector<mpz_class> &numbers) {
+    ParameterTable::instance().setRows(withRow(rows, row));
+
+    std::vector<double> times;
+    for (uint32_t i = 0; i < measureRuns; ++i)
+      times.emplace_back(run(numbers));
+
+    std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+  }
+
+  // Variants of one parameter around current row for numbers with 'digits' digits
+  std::vector<std::function<Parameters(Parameters)> > moves(uint32_t digits) {
+    std::vector<std::function<Parameters(Parameters)> > result;
+
+    for (const double scale: {0.6, 0.8, 1.25, 1.6}) {
+      result.emplace_back([scale](Parameters row) {
+        row.factorBaseSize = std::max<uint32_t>(16, static_cast<uint32_t>(row.factorBaseSize * scale));
+        row.factorBaseSize = std::min(ParameterTable::maxFactorBaseSize, row.factorBaseSize);
+        return row;
+      });
+    }
+
+    for (const double scale: {0.5, 2.0}) {
+      result.emplace_back([scale](Parameters row) {
+        row.halfInterval = std::max(minHalfInterval, static_cast<uint32_t>(row.halfInterval * scale));
+        row.halfInterval = std::min(ParameterTable::maxHalfInterval, row.halfInterval);
+        return row;
+      });
+      result.emplace_back([scale](Parameters row) {
+        row.largePrimeMultiplier = std::max<uint32_t>(1, static_cast<uint32_t>(row.largePrimeMultiplier * scale));
+        row.largePrimeMultiplier = std::min(ParameterTable::maxLargePrimeMultiplier, row.largePrimeMultiplier);
+        return row;
+      });
+    }
+
+    for (const double delta: {-0.3, -0.15, 0.15, 0.3}) {
+      result.emplace_back([delta](Parameters row) {
+        row.thresholdFactor = std::max(0.5, row.thresholdFactor + delta);
+        return row;
+      });
+    }
+
+    // Classic sieve doesn't read count of large primes
+    if (digits >= ParameterTable::siqsMinDigits) {
+      result.emplace_back([](Parameters row) {
+        row.largePrimes = 3 - row.largePrimes;
+        return row;
+      });
+    }
+
+    return result;
+  }
+
+  void print(const char *title, const Parameters &row, double time) {
+    std::printf("%-6s %3u digits: factor base %6u, half interval %7u, threshold %.2f, "
+                "large prime x%u, %u large primes: %.3f s\n",
+                title, row.digits, row.factorBaseSize, row.halfInterval, row.thresholdFactor,
+                row.largePrimeMultiplier, row.largePrimes, time);
+  }
+
+}
+
+int main(int argc, char **argv) {
+  const std::string output = argc > 1 ? argv[1] : defaultOutput;
+  const uint32_t numbers = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : defaultNumbers;
+
+  std::vector<uint32_t> digits;
+  for (int i = 3; i < argc; ++i)
+    digits.emplace_back(static_cast<uint32_t>(std::strtoul(argv[i], nullptr, 10)));
+  if (digits.empty())
+    digits.assign(std::begin(defaultDigits), std::end(defaultDigits));
+
+  auto &table = ParameterTable::instance();
+
+  // Wrong table is reported and tuning starts from default parameters
+  try {
+    table.load(output);
+  }
+  catch (std::invalid_argument &e) {
+    std::fprintf(stderr, "%s: %s Default parameters are used.\n", output.c_str(), e.what());
+  }
+  std::vector<Parameters> rows = table.rows();
+
+  gmp_randclass random(gmp_randinit_default);
+  random.seed(corpusSeed);
+
+  for (const auto &size: digits) {
+    const auto corpus = semiprimes(size, numbers, random);
+
+    Parameters best = table.get(size);
+
+    // The first run pays for growth of prime table and for cache loading, so it isn't timed
+    table.setRows(withRow(rows, best));
+    run(corpus);
+
+    double bestTime = measure(rows, best, corpus);
+    print("start", best, bestTime);
+
+    bool improved = true;
+    for (uint32_t pass = 0; pass < maxPasses && improved; ++pass) {
+      improved = false;
+
+      for (const auto &move: moves(size)) {
+        const Parameters candidate = move(best);
+        const double time = measure(rows, candidate, corpus);
+
+        if (time < bestTime * minGain) {
+          best = candidate;
+          bestTime = time;
+          improved = true;
+          print("better", best, bestTime);
+        }
+      }
+    }
+
+    rows = withRow(rows, best);
+    table.setRows(rows);
+    table.save(output);
+  }
+
+  std::printf("Table is written to %s\n", output.c_str());
+  return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file SieveBenchmark.cpp
+ * Comparison of sieve engines on ranges of different size and height.
+ * Prints time of every engine and engine, which SieveEngine::select chooses.
+ * Then iteration over primes from gap list (PrimeGaps) is compared with plain vector.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <SieveEngine/SieveEngine.h>
+#include <PrimeGaps/PrimeGaps.h>
+
+#include <chrono>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+namespace {
+
+  // Atkin isn't run above it, it keeps byte for every number
+  const uint64_t atkinBenchmarkLimit = 1ull << 28;
+
+  // Primes up to it are iterated, every list is walked several times
+  const uint64_t iterationLimit = 1ull << 28;
+  const uint32_t iterationRounds = 10;
+
+  double measure(const SieveEngine &engine, uint64_t low, uint64_t high, size_t &count) {
+    std::vector<uint64_t> primes;
+    const auto start = std::chrono::steady_clock::now();
+    engine.sieve(low, high, primes);
+    const auto finish = std::chrono::steady_clock::now();
+
+    count = primes.size();
+    return std::chrono::duration<double>(finish - start).count();
+  }
+
+  // Time of one pass over container, sum keeps loop from being removed
+  template<typename Container>
+  double measureIteration(const Container &primes, long long &sum) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < iterationRounds; ++round) {
+      for (auto it = primes.begin(); it != primes.end(); ++it) {
+        sum += *it;
+      }
+    }
+    const auto finish = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(finish - start).count() / iterationRounds;
+  }
+
+}
+
+int main() {
+  const std::vector<std::pair<uint64_t, uint64_t> > ranges{
+      {0, 1ull << 12}, {0, 1ull << 16}, {0, 1ull << 20}, {0, 1ull << 24}, {0, 1ull << 28},
+      {1ull << 32, (1ull << 32) + (1ull << 24)}, {1ull << 36, (1ull << 36) + (1ull << 24)},
+      {1ull << 40, (1ull << 40) + (1ull << 24)}, {1ull << 44, (1ull << 44) + (1ull << 24)},
+      {1ull << 48, (1ull << 48) + (1ull << 24)}, {1ull << 32, (1ull << 32) + (1ull << 28)},
+      {1ull << 40, (1ull << 40) + (1ull << 28)}, {1ull << 50, (1ull << 50) + (1ull << 28)}};
+
+  const SieveEngine::Kind kinds[] = {SieveEngine::Kind::Atkin, SieveEngine::Kind::Eratosthenes,
+                                     SieveEngine::Kind::Bucket};
+
+  std::printf("%-22s %-22s %10s %12s %12s %12s  %s\n", "low", "high", "primes", "Atkin", "Eratosthenes",
+              "Bucket", "selected");
+
+  for (const auto &range: ranges) {
+    size_t count = 0;
+    std::printf("%-22llu %-22llu", static_cast<unsigned long long>(range.first),
+                static_cast<unsigned long long>(range.second));
+
+    std::vector<double> times;
+    for (const auto &kind: kinds) {
+      const auto engine = SieveEngine::create(kind);
+      if (kind == SieveEngine::Kind::Atkin && (range.first != 0 || range.second > atkinBenchmarkLimit)) {
+        times.emplace_back(-1);
+        continue;
+      }
+      times.emplace_back(measure(*engine, range.first, range.second, count));
+    }
+
+    std::printf(" %10zu", count);
+    for (const auto &time: times) {
+      if (time < 0)
+        std::printf(" %12s", "-");
+      else
+        std::printf(" %12.6f", time);
+    }
+
+    const auto selected = SieveEngine::create(SieveEngine::select(range.first, range.second));
+    std::printf("  %s\n", selected->name());
+  }
+
+  std::vector<uint64_t> found;
+  SieveEngine::create(SieveEngine::select(0, iterationLimit))->sieve(0, iterationLimit, found);
+
+  std::vector<long long> plain(found.begin(), found.end());
+  PrimeGaps gaps;
+  for (const auto &prime: found) {
+    gaps.push_back(static_cast<long long>(prime));
+  }
+
+  long long plainSum = 0;
+  long long gapsSum = 0;
+  const double plainTime = measureIteration(plain, plainSum);
+  const double gapsTime = measureIteration(gaps, gapsSum);
+
+  std::printf("\n%-22s %10s %12s %12s %12s %12s\n", "iteration up to", "primes", "vector", "gaps",
+              "vector MB", "gaps MB");
+  std::printf("%-22llu %10zu %12.6f %12.6f %12.1f %12.1f%s\n", static_cast<unsigned long long>(iterationLimit),
+              plain.size(), plainTime, gapsTime, plain.size() * sizeof(long long) / 1e6, gaps.bytes() / 1e6,
+              plainSum == gapsSum ? "" : "  (sums differ)");
+
+  return 0;
+}
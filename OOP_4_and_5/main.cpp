@@ -1,7 +1,22 @@
 #include <Worker/Worker.h>
+#include <PrimeTable/PrimeTable.h>
+#include <ParameterTable/ParameterTable.h>
+
+#include <iostream>
+#include <stdexcept>
 
 int main()
 {
+  PrimeTable::instance().setCacheFile("primes.cache");
+
+  // Table, which was written by AutoTune, replaces default parameters. Wrong table is reported and ignored.
+  try {
+    ParameterTable::instance().load("parameters.txt");
+  }
+  catch (std::invalid_argument &e) {
+    std::cerr << "parameters.txt: " << e.what() << " Default parameters are used.\n";
+  }
+
   Worker x("text.in", "text.out");
   x.start();
   return 0;
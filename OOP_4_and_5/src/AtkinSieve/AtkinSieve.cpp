@@ -9,174 +9,229 @@
  * @version 1.0
  */
 #include <AtkinSieve/AtkinSieve.h>
+#include <SieveEngine/SieveEngine.h>
 
-#include <cmath>
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
 #include <thread>
 
-void AtkinSieve::fillNumbersToPrimes(const long long &limit) {
-  std::set<long long> temp;
-  this->primes_.clear();
+namespace {
 
-  for (const auto& i: this->first_primes){
-    temp.emplace(i);
-  }
+  // Range is split into parts for threads, several parts per thread balance load
+  const uint64_t minParallelRange = 1ull << 22;
+  const uint64_t partsPerThread = 8;
 
-  for (long long i = 0; i <= limit; i++){
-    if (this->is_prime_[i]){
-      temp.emplace(i);
-    }
+}
+
+AtkinSieve::AtkinSieve(uint32_t threads, Storage storage)
+    : storage_(storage), rangeLow_(0), maxCurrentLimits_(0), primesEnd_(0), gapsEnd_(gaps_.end()),
+      threads_(threads) {
+  if (this->threads_ == 0) {
+    this->threads_ = std::max(1u, std::thread::hardware_concurrency());
   }
 
-  std::copy(temp.begin(), temp.end(), std::back_inserter(this->primes_));
-  temp.clear();
+  this->bitmap_.reset(0, 0);
 }
 
 void AtkinSieve::setPrimes(const long long &limit) {
-  if (this->maxCurrentLimits_ >= limit) {
-    fillNumbersToPrimes(limit);
-    return;
+  if (limit < 0)
+    throw std::invalid_argument("Wrong limit");
+
+  // Only prefix [0, maxCurrentLimits_] can be extended
+  if (this->rangeLow_ != 0) {
+    this->rangeLow_ = 0;
+    this->maxCurrentLimits_ = 0;
+    this->clearPrimes();
+    this->bitmap_.reset(0, 0);
+    this->cache_.reset();
   }
 
-  this->maxCurrentLimits_ = limit;
-  this->is_prime_.assign(limit + 1, false);
-
-
-  // Put in candidate primes_: integers which have an odd number of representations by certain quadratic forms.
-  this->firstStepAlgorithm(limit);
-  this->secondStepAlgorithm(limit);
-  this->thirdStepAlgorithm(limit);
-
-  this->sieving(limit);
-
-  for (const auto& i: this->first_primes){
-    is_prime_[i] = true;
+  // Only new part of range is sieved
+  if (limit > this->maxCurrentLimits_) {
+    this->appendRange(this->maxCurrentLimits_ == 0 ? 0 : this->maxCurrentLimits_ + 1, limit);
+    this->maxCurrentLimits_ = limit;
   }
 
-  fillNumbersToPrimes(limit);
+  // Smaller limit is served by prefix of stored primes
+  this->setPrimesEnd(this->upperBound(limit));
 }
 
-// Algorithm step 3.1:
-void AtkinSieve::firstStepAlgorithm(const long long& limit) {
-  const auto sqrt_limits = static_cast<long long>(std::ceil(std::sqrt(limit)));
+void AtkinSieve::setPrimes(const long long &low, const long long &high) {
+  if (low < 0 || high < low)
+    throw std::invalid_argument("Wrong range");
 
-  for (long long x = 1; x <= sqrt_limits; ++x) {
-    for (long long y = 1; y <= sqrt_limits; y += 2) {
-      const auto n = static_cast<long long>(4 * std::pow(x, 2) + std::pow(y, 2));
+  this->clearPrimes();
+  this->bitmap_.reset(low, high);
+  this->cache_.reset();
+  this->rangeLow_ = low;
+  this->maxCurrentLimits_ = high;
 
-      if (n > limit)
-        continue;
+  this->appendRange(low, high);
+  this->setPrimesEnd(this->storedSize());
+}
 
-      if (this->firstInvariants.find(n % 60) != this->firstInvariants.end()) {
-        this->reverseStatePrime(n);
-      }
-    }
+bool AtkinSieve::loadCache(const std::string &fileName) {
+  std::unique_ptr<PrimeCache> cache(new PrimeCache(fileName));
+  if (cache->empty())
+    return false;
+
+  const PrimeCache::Table table = cache->table();
+  this->rangeLow_ = 0;
+  this->maxCurrentLimits_ = table.limit;
+  this->bitmap_.map(table.bits, table.bytes);
+
+  if (this->storage_ == Storage::Gaps) {
+    this->gaps_.map(table.primes);
+  } else {
+    PrimeGaps mapped;
+    mapped.map(table.primes);
+    this->primes_.assign(mapped.begin(), mapped.end());
   }
-}
 
-// Algorithm step 3.2:
-void AtkinSieve::secondStepAlgorithm(const long long& limit) {
-  const auto sqrt_limits = static_cast<long long>(std::ceil(std::sqrt(limit)));
+  // Old mapping isn't used any more
+  this->cache_ = std::move(cache);
 
-  for (long long x = 1; x <= sqrt_limits; x += 2) {
-    for (long long y = 2; y <= sqrt_limits; y += 2) {
-      const auto n = static_cast<long long>(3 * std::pow(x, 2) + std::pow(y, 2));
+  this->setPrimesEnd(this->storedSize());
+  return true;
+}
 
-      if (n > limit)
-        continue;
+bool AtkinSieve::saveCache(const std::string &fileName) const {
+  if (this->rangeLow_ != 0)
+    throw std::invalid_argument("Only primes from 0 can be saved");
 
-      if (this->secondInvariants.find(n % 60) != this->secondInvariants.end()) {
-        this->reverseStatePrime(n);
-      }
-    }
+  if (this->storage_ == Storage::Gaps) {
+    return PrimeCache::write(fileName, {this->maxCurrentLimits_, this->bitmap_.bits(), this->bitmap_.bytes(),
+                                        this->gaps_.view()});
   }
+
+  // File keeps primes as gap list in any case
+  PrimeGaps gaps;
+  for (const auto &prime: this->primes_)
+    gaps.push_back(prime);
+
+  return PrimeCache::write(fileName, {this->maxCurrentLimits_, this->bitmap_.bits(), this->bitmap_.bytes(),
+                                      gaps.view()});
 }
 
-// Algorithm step 3.3:
-void AtkinSieve::thirdStepAlgorithm(const long long& limit) {
-  const auto sqrt_limits = static_cast<unsigned long long>(std::ceil(std::sqrt(limit)));
+void AtkinSieve::appendRange(const long long &low, const long long &high) {
+  const auto width = static_cast<uint64_t>(high - low) + 1;
+  const uint64_t parts = std::min<uint64_t>(this->threads_ * partsPerThread, width / minParallelRange + 1);
+  const uint64_t part = (width + parts - 1) / parts;
 
-  for (unsigned long long x = 2; x <= sqrt_limits; ++x) {
-    for (unsigned long long y = 1; y <= x - 1; ++y) {
-      const auto n = static_cast<long long>(3 * std::pow(x, 2) - std::pow(y, 2));
+  // Threads take parts in turn, primes of every part are kept apart and concatenated in order
+  std::vector<std::vector<uint64_t> > found(parts);
+  std::atomic<uint64_t> nextPart(0);
 
-      if (n > limit)
+  auto worker = [&]() {
+    for (uint64_t i = nextPart++; i < parts; i = nextPart++) {
+      const uint64_t begin = low + i * part;
+      const uint64_t end = std::min<uint64_t>(high, begin + part - 1);
+      if (begin > end)
         continue;
 
-      if (this->thirdInvariants.find(n % 60) != this->thirdInvariants.end()) {
-        this->reverseStatePrime(n);
-      }
+      SieveEngine::create(SieveEngine::select(begin, end))->sieve(begin, end, found[i]);
+    }
+  };
+
+  const auto count = static_cast<uint32_t>(std::min<uint64_t>(this->threads_, parts));
+  if (count <= 1) {
+    worker();
+  } else {
+    std::vector<std::thread> workers;
+    for (uint32_t t = 0; t < count; ++t) {
+      workers.emplace_back(worker);
     }
-  }
-
-}
-
-void AtkinSieve::sievingOneWheel(const long long &p, const long long& limit) {
-  long long wheel = 0;
-  long long number = p;
-
-  while ( number * number <= limit ){
-    if (is_prime_[number] && number >= 7) {
-
-      // n is prime, omit multiples of its square; this is sufficient
-      // because square-free composites can't get on this list
-      for (const auto &prime: this->sieving_primes) {
-        long long wheel_prime = 0;
-        const long long number_q = number * number;
-        long long c = number_q * prime;
 
-        while (c <= limit) {
-          this->setStatePrime(c, false);
+    for (auto &thread: workers) {
+      thread.join();
+    }
+  }
 
-          wheel_prime++;
-          c = number_q * (60 * wheel_prime + prime);
-        }
+  this->bitmap_.extend(high);
+  for (auto &primes: found) {
+    for (const auto &prime: primes) {
+      if (this->storage_ == Storage::Gaps) {
+        this->gaps_.push_back(static_cast<long long>(prime));
+      } else {
+        this->primes_.push_back(static_cast<long long>(prime));
       }
+      this->bitmap_.set(static_cast<long long>(prime));
     }
-
-    wheel++;
-    number = 60 * wheel + p;
+    std::vector<uint64_t>().swap(primes);
   }
 }
 
-// Eliminate composites by sieving, only for those occurrences on the wheel:
-void AtkinSieve::sieving(const long long &limit) {
-  for (const auto& prime: this->sieving_primes){
-    this->sievingOneWheel(prime, limit);
-  }
+void AtkinSieve::clearPrimes() {
+  this->primes_.clear();
+  this->gaps_.clear();
 }
 
-void AtkinSieve::reverseStatePrime(const long long &pos) {
-  this->is_prime_[pos] = !this->is_prime_[pos];
+size_t AtkinSieve::upperBound(long long value) const {
+  if (this->storage_ == Storage::Gaps)
+    return this->gaps_.upperBound(value);
+
+  return std::upper_bound(this->primes_.begin(), this->primes_.end(), value) - this->primes_.begin();
 }
 
-void AtkinSieve::setStatePrime(const long long &pos, const bool &state) {
-  this->is_prime_[pos] = state;
+size_t AtkinSieve::storedSize() const {
+  return this->storage_ == Storage::Gaps ? this->gaps_.size() : this->primes_.size();
 }
 
 size_t AtkinSieve::size() const {
-  return this->primes_.size();
+  return this->primesEnd_;
+}
+
+long long AtkinSieve::limit() const {
+  return this->maxCurrentLimits_;
 }
 
 long long AtkinSieve::operator[](size_t n) const{
-  if ( n >= this->primes_.size() ){
+  if ( n >= this->primesEnd_ ){
     throw std::invalid_argument("N more than size()");
   }
 
-  return this->primes_[n];
+  return this->storage_ == Storage::Gaps ? this->gaps_[n] : this->primes_[n];
 }
 
 std::vector<long long>::const_iterator AtkinSieve::begin() const {
+  if (this->storage_ != Storage::Vector)
+    throw std::invalid_argument("Primes are kept as gap list, use compactBegin()");
+
   return this->primes_.begin();
 }
 
 std::vector<long long>::const_iterator AtkinSieve::end() const {
-  return this->primes_.end();
+  if (this->storage_ != Storage::Vector)
+    throw std::invalid_argument("Primes are kept as gap list, use compactEnd()");
+
+  return this->primes_.begin() + this->primesEnd_;
+}
+
+PrimeGaps::const_iterator AtkinSieve::compactBegin() const {
+  if (this->storage_ != Storage::Gaps)
+    throw std::invalid_argument("Primes are kept as vector, use begin()");
+
+  return this->gaps_.begin();
+}
+
+PrimeGaps::const_iterator AtkinSieve::compactEnd() const {
+  if (this->storage_ != Storage::Gaps)
+    throw std::invalid_argument("Primes are kept as vector, use end()");
+
+  return this->gapsEnd_;
+}
+
+void AtkinSieve::setPrimesEnd(size_t primesEnd) {
+  this->primesEnd_ = primesEnd;
+
+  if (this->storage_ == Storage::Gaps)
+    this->gapsEnd_ = this->gaps_.iteratorAt(primesEnd);
 }
 
 bool AtkinSieve::isPrime(const long long& n) const{
-  if (n >= this->is_prime_.size())
-    throw std::invalid_argument("N more then size()");
+  if (n < this->rangeLow_ || n > this->maxCurrentLimits_)
+    throw std::invalid_argument("N is out of range");
 
-  return this->is_prime_[n];
+  return this->bitmap_.test(n);
 }
@@ -0,0 +1,386 @@
+/**
+ * @file BlockLanczos.cpp
+ * Montgomery's block Lanczos algorithm for finding nullspace of sparse matrix over GF(2).
+ * Description:
+ * https://link.springer.com/content/pdf/10.1007/3-540-49264-X_9.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#include <BlockLanczos/BlockLanczos.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+  inline uint64_t bit(uint32_t i) {
+    return uint64_t(1) << i;
+  }
+
+  inline uint64_t parity(uint64_t x) {
+    return static_cast<uint64_t>(__builtin_parityll(x));
+  }
+
+}
+
+BlockLanczos::BlockLanczos(const SparseMatrix &matrix) : matrix_(matrix), random_(std::random_device()()) {}
+
+void BlockLanczos::multiplyInner(const std::vector<uint64_t> &x, const std::vector<uint64_t> &y,
+                                 uint64_t *result) const {
+  std::vector<std::array<uint64_t, 64> > partial(this->matrix_.threads());
+  for (auto &i: partial) {
+    i.fill(0);
+  }
+
+  this->matrix_.parallelFor(x.size(), [&](size_t begin, size_t end, uint32_t thread) {
+    // c[b][v] is sum of y[i], where byte b of x[i] is v
+    std::vector<uint64_t> c(8 * 256, 0);
+
+    for (size_t i = begin; i < end; ++i) {
+      const uint64_t xi = x[i];
+      const uint64_t yi = y[i];
+      for (uint32_t b = 0; b < 8; ++b) {
+        c[b * 256 + ((xi >> (8 * b)) & 0xff)] ^= yi;
+      }
+    }
+
+    for (uint32_t b = 0; b < 8; ++b) {
+      for (uint32_t j = 0; j < 8; ++j) {
+        uint64_t accumulate = 0;
+        for (uint32_t v = 0; v < 256; ++v) {
+          if (v & bit(j))
+            accumulate ^= c[b * 256 + v];
+        }
+        partial[thread][8 * b + j] = accumulate;
+      }
+    }
+  });
+
+  std::fill(result, result + 64, 0);
+  for (const auto &i: partial) {
+    for (uint32_t j = 0; j < 64; ++j) {
+      result[j] ^= i[j];
+    }
+  }
+}
+
+void BlockLanczos::multiplyAccumulate(const std::vector<uint64_t> &x, const uint64_t *m,
+                                      std::vector<uint64_t> &y) const {
+  // table[b][v] is sum of rows of m, which are chosen by byte b equals v
+  std::vector<uint64_t> table(8 * 256, 0);
+  for (uint32_t b = 0; b < 8; ++b) {
+    for (uint32_t v = 1; v < 256; ++v) {
+      table[b * 256 + v] = table[b * 256 + (v & (v - 1))] ^ m[8 * b + __builtin_ctz(v)];
+    }
+  }
+
+  this->matrix_.parallelFor(x.size(), [&](size_t begin, size_t end, uint32_t) {
+    for (size_t i = begin; i < end; ++i) {
+      const uint64_t xi = x[i];
+      uint64_t accumulate = 0;
+      for (uint32_t b = 0; b < 8; ++b) {
+        accumulate ^= table[b * 256 + ((xi >> (8 * b)) & 0xff)];
+      }
+      y[i] ^= accumulate;
+    }
+  });
+}
+
+void BlockLanczos::multiplySmall(const uint64_t *a, const uint64_t *b, uint64_t *c) {
+  uint64_t temp[64];
+
+  for (uint32_t i = 0; i < 64; ++i) {
+    uint64_t accumulate = 0;
+    uint64_t ai = a[i];
+    for (uint32_t j = 0; ai != 0; ++j, ai >>= 1) {
+      if (ai & 1)
+        accumulate ^= b[j];
+    }
+    temp[i] = accumulate;
+  }
+
+  std::memcpy(c, temp, sizeof(temp));
+}
+
+/**
+ * Choose subset S of columns, so S^T * T * S is invertible and contains all columns,
+ * which weren't in previous subset. w = S * (S^T * T * S)^(-1) * S^T.
+ * Return size of S.
+ */
+uint32_t BlockLanczos::findNonsingularSub(const uint64_t *t, uint32_t *s, const uint32_t *lastS, uint32_t lastDim,
+                                          uint64_t *w) {
+  // M = [t | I]
+  uint64_t M[64][2];
+  for (uint32_t i = 0; i < 64; ++i) {
+    M[i][0] = t[i];
+    M[i][1] = bit(i);
+  }
+
+  // Columns from previous subset are in the end of s
+  uint32_t dim = 0;
+  uint32_t cols = 64;
+  uint64_t mask = 0;
+  for (uint32_t i = 0; i < lastDim; ++i) {
+    s[--cols] = lastS[i];
+    mask |= bit(lastS[i]);
+  }
+  for (uint32_t i = 0; i < 64; ++i) {
+    if (!(mask & bit(i)))
+      s[dim++] = i;
+  }
+
+  dim = 0;
+  for (uint32_t i = 0; i < 64; ++i) {
+    mask = bit(s[i]);
+    uint64_t *rowI = M[s[i]];
+
+    // Find pivot row and put it in row i
+    uint32_t j;
+    for (j = i; j < 64; ++j) {
+      uint64_t *rowJ = M[s[j]];
+      if (rowJ[0] & mask) {
+        std::swap(rowI[0], rowJ[0]);
+        std::swap(rowI[1], rowJ[1]);
+        break;
+      }
+    }
+
+    if (j < 64) {
+      for (j = 0; j < 64; ++j) {
+        uint64_t *rowJ = M[s[j]];
+        if (rowI != rowJ && (rowJ[0] & mask)) {
+          rowJ[0] ^= rowI[0];
+          rowJ[1] ^= rowI[1];
+        }
+      }
+
+      s[dim++] = s[i];
+      continue;
+    }
+
+    // Pivot wasn't found, use right half of M
+    for (j = i; j < 64; ++j) {
+      uint64_t *rowJ = M[s[j]];
+      if (rowJ[1] & mask) {
+        std::swap(rowI[0], rowJ[0]);
+        std::swap(rowI[1], rowJ[1]);
+        break;
+      }
+    }
+
+    if (j == 64)
+      return 0;
+
+    for (j = 0; j < 64; ++j) {
+      uint64_t *rowJ = M[s[j]];
+      if (rowI != rowJ && (rowJ[1] & mask)) {
+        rowJ[0] ^= rowI[0];
+        rowJ[1] ^= rowI[1];
+      }
+    }
+
+    rowI[0] = rowI[1] = 0;
+  }
+
+  for (uint32_t i = 0; i < 64; ++i) {
+    w[i] = M[i][1];
+  }
+
+  return dim;
+}
+
+std::vector<uint64_t> BlockLanczos::solve() {
+  const uint32_t n = this->matrix_.cols();
+
+  std::vector<uint64_t> x(n);
+  std::vector<uint64_t> v0;
+  std::vector<uint64_t> v[3];
+  std::vector<uint64_t> vnext(n, 0);
+
+  // x starts from random Y and v_0 = A * Y, so in the end A * x = A * Y + v_0 = 0
+  for (auto &i: x) {
+    i = this->random_();
+  }
+  this->matrix_.multiplySymmetric(x, v[0]);
+  v0 = v[0];
+  v[1].assign(n, 0);
+  v[2].assign(n, 0);
+
+  uint64_t vtAv[2][64] = {};
+  uint64_t vtA2v[2][64] = {};
+  uint64_t winv[3][64] = {};
+  uint64_t d[64], e[64], f[64], f2[64];
+
+  uint32_t s[2][64];
+  uint32_t dim1 = 64;
+  uint64_t mask1 = ~uint64_t(0);
+  for (uint32_t i = 0; i < 64; ++i) {
+    s[1][i] = i;
+  }
+
+  // Expected count of iterations is n / 63.24
+  const uint32_t maxIterations = n / 60 + 100;
+
+  for (uint32_t iteration = 0;; ++iteration) {
+    if (iteration > maxIterations)
+      return {};
+
+    this->matrix_.multiplySymmetric(v[0], vnext);
+    this->multiplyInner(v[0], vnext, vtAv[0]);
+    this->multiplyInner(vnext, vnext, vtA2v[0]);
+
+    // v_i^T * A * v_i = 0, iteration is finished
+    if (std::all_of(vtAv[0], vtAv[0] + 64, [](uint64_t i) { return i == 0; }))
+      break;
+
+    const uint32_t dim0 = findNonsingularSub(vtAv[0], s[0], s[1], dim1, winv[0]);
+
+    uint64_t mask0 = 0;
+    for (uint32_t i = 0; i < dim0; ++i) {
+      mask0 |= bit(s[0][i]);
+    }
+
+    // All columns must be used in current or previous iteration.
+    // It breaks only near the end of iteration, so nullspace is searched in current span.
+    if (dim0 == 0 || (mask0 | mask1) != ~uint64_t(0))
+      break;
+
+    // d = I - winv_i * (v_i^T * A^2 * v_i * S_i * S_i^T + v_i^T * A * v_i)
+    for (uint32_t i = 0; i < 64; ++i) {
+      d[i] = (vtA2v[0][i] & mask0) ^ vtAv[0][i];
+    }
+    multiplySmall(winv[0], d, d);
+    for (uint32_t i = 0; i < 64; ++i) {
+      d[i] ^= bit(i);
+    }
+
+    // e = -winv_(i-1) * v_i^T * A * v_i * S_i * S_i^T
+    multiplySmall(winv[1], vtAv[0], e);
+    for (uint32_t i = 0; i < 64; ++i) {
+      e[i] &= mask0;
+    }
+
+    // f = -winv_(i-2) * (I - v_(i-1)^T * A * v_(i-1) * winv_(i-1)) *
+    //     (v_(i-1)^T * A^2 * v_(i-1) * S_(i-1) * S_(i-1)^T + v_(i-1)^T * A * v_(i-1)) * S_i * S_i^T
+    multiplySmall(vtAv[1], winv[1], f);
+    for (uint32_t i = 0; i < 64; ++i) {
+      f[i] ^= bit(i);
+    }
+    multiplySmall(winv[2], f, f);
+    for (uint32_t i = 0; i < 64; ++i) {
+      f2[i] = ((vtA2v[1][i] & mask1) ^ vtAv[1][i]) & mask0;
+    }
+    multiplySmall(f, f2, f);
+
+    // v_(i+1) = A * v_i * S_i * S_i^T + v_i * d + v_(i-1) * e + v_(i-2) * f
+    for (auto &i: vnext) {
+      i &= mask0;
+    }
+    this->multiplyAccumulate(v[0], d, vnext);
+    this->multiplyAccumulate(v[1], e, vnext);
+    this->multiplyAccumulate(v[2], f, vnext);
+
+    // x += v_i * winv_i * v_i^T * v_0
+    this->multiplyInner(v[0], v0, d);
+    multiplySmall(winv[0], d, d);
+    this->multiplyAccumulate(v[0], d, x);
+
+    std::swap(v[2], v[1]);
+    std::swap(v[1], v[0]);
+    std::swap(v[0], vnext);
+
+    std::memcpy(winv[2], winv[1], sizeof(winv[1]));
+    std::memcpy(winv[1], winv[0], sizeof(winv[0]));
+    std::memcpy(vtAv[1], vtAv[0], sizeof(vtAv[0]));
+    std::memcpy(vtA2v[1], vtA2v[0], sizeof(vtA2v[0]));
+    std::memcpy(s[1], s[0], sizeof(s[0]));
+    mask1 = mask0;
+    dim1 = dim0;
+  }
+
+  std::vector<uint64_t> result;
+  this->combineNullspace(x, v[0], result);
+  return result;
+}
+
+/**
+ * A * x is in span of last v, so nullspace of B is searched in span of columns [x | v]:
+ * Gaussian elimination of columns of B * [x | v] gives their zero combinations.
+ */
+void BlockLanczos::combineNullspace(const std::vector<uint64_t> &x, const std::vector<uint64_t> &v,
+                                    std::vector<uint64_t> &result) const {
+  std::vector<uint64_t> bx;
+  std::vector<uint64_t> bv;
+  this->matrix_.multiply(x, bx);
+  this->matrix_.multiply(v, bv);
+
+  // Column j of transform is combination of columns [x | v], which is in column j now
+  uint64_t transform[128][2] = {};
+  for (uint32_t t = 0; t < 64; ++t) {
+    transform[t][0] = bit(t);
+    transform[t + 64][1] = bit(t);
+  }
+
+  uint64_t active[2] = {~uint64_t(0), ~uint64_t(0)};
+
+  for (uint32_t r = 0; r < bx.size(); ++r) {
+    const uint64_t c0 = bx[r] & active[0];
+    const uint64_t c1 = bv[r] & active[1];
+    if (c0 == 0 && c1 == 0)
+      continue;
+
+    // Pivot is lowest nonzero column
+    const uint64_t pivot0 = c0 & (~c0 + 1);
+    const uint64_t pivot1 = c0 != 0 ? 0 : c1 & (~c1 + 1);
+    const uint64_t mask0 = c0 ^ pivot0;
+    const uint64_t mask1 = c1 ^ pivot1;
+
+    for (uint32_t k = r; k < bx.size(); ++k) {
+      if ((bx[k] & pivot0) || (bv[k] & pivot1)) {
+        bx[k] ^= mask0;
+        bv[k] ^= mask1;
+      }
+    }
+
+    for (auto &t: transform) {
+      if ((t[0] & pivot0) || (t[1] & pivot1)) {
+        t[0] ^= mask0;
+        t[1] ^= mask1;
+      }
+    }
+
+    active[0] ^= pivot0;
+    active[1] ^= pivot1;
+  }
+
+  result.assign(x.size(), 0);
+  uint32_t count = 0;
+
+  for (uint32_t j = 0; j < 128 && count < 64; ++j) {
+    const uint64_t column = bit(j % 64);
+    if (!(active[j / 64] & column))
+      continue;
+
+    uint64_t combination[2] = {0, 0};
+    for (uint32_t t = 0; t < 128; ++t) {
+      if (transform[t][j / 64] & column)
+        combination[t / 64] |= bit(t % 64);
+    }
+
+    bool isZero = true;
+    for (uint32_t i = 0; i < x.size(); ++i) {
+      const uint64_t value = parity(x[i] & combination[0]) ^ parity(v[i] & combination[1]);
+      result[i] |= value << count;
+      isZero = isZero && value == 0;
+    }
+
+    if (!isZero)
+      ++count;
+  }
+
+  if (count == 0)
+    result.clear();
+}
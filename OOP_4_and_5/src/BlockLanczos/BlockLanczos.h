@@ -0,0 +1,52 @@
+/**
+ * @file BlockLanczos.h
+ * Montgomery's block Lanczos algorithm for finding nullspace of sparse matrix over GF(2).
+ * Iteration works with symmetric matrix A = B^T * B and blocks of 64 vectors.
+ * Description:
+ * https://link.springer.com/content/pdf/10.1007/3-540-49264-X_9.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_BLOCKLANCZOS_H
+#define OOP_4_AND_5_BLOCKLANCZOS_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <SparseMatrix/SparseMatrix.h>
+
+class BlockLanczos final {
+
+ public:
+  explicit BlockLanczos(const SparseMatrix &matrix);
+  BlockLanczos(const BlockLanczos &) = delete;
+  BlockLanczos &operator=(const BlockLanczos &) = delete;
+
+  // Find up to 64 vectors x with B * x = 0.
+  // Bit k of result[i] is i-th coordinate of k-th vector.
+  // Empty result means that iteration failed.
+  std::vector<uint64_t> solve();
+
+ private:
+  // Block of 64 vectors: result = x^T * y (64 x 64)
+  void multiplyInner(const std::vector<uint64_t> &x, const std::vector<uint64_t> &y, uint64_t *result) const;
+
+  // y ^= x * m, where m is 64 x 64 matrix
+  void multiplyAccumulate(const std::vector<uint64_t> &x, const uint64_t *m, std::vector<uint64_t> &y) const;
+
+  static void multiplySmall(const uint64_t *a, const uint64_t *b, uint64_t *c);
+
+  static uint32_t findNonsingularSub(const uint64_t *t, uint32_t *s, const uint32_t *lastS, uint32_t lastDim,
+                                     uint64_t *w);
+
+  void combineNullspace(const std::vector<uint64_t> &x, const std::vector<uint64_t> &v,
+                        std::vector<uint64_t> &result) const;
+
+  const SparseMatrix &matrix_;
+  std::mt19937_64 random_;
+};
+
+#endif //OOP_4_AND_5_BLOCKLANCZOS_H
@@ -0,0 +1,92 @@
+/**
+ * @file BucketSieve.cpp
+ * Segmented sieve of Eratosthenes with buckets for large primes.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <BucketSieve/BucketSieve.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+
+#include <algorithm>
+
+BucketSieve::BucketSieve(uint64_t low, uint64_t high, uint32_t blockSize)
+    : low_(low), high_(high), blockSize_(blockSize), current_(low & ~1ull), start_(low & ~1ull),
+      blockNumber_(0), finished_(high < low), block_(blockSize) {
+
+  const auto primes = SegmentedSieve::smallPrimes(high);
+  const uint64_t span = 2ull * blockSize;
+
+  // Multiple of the largest prime is at most so many blocks ahead
+  const uint64_t ring = primes.empty() ? 1 : 2ull * primes.back() / span + 2;
+  this->buckets_.resize(ring);
+
+  for (const auto &p: primes) {
+    const uint64_t square = static_cast<uint64_t>(p) * p;
+    uint64_t start = std::max(square, (this->current_ + p) / p * p);
+    if ((start & 1) == 0)
+      start += p;
+
+    if (p <= blockSize) {
+      this->smallPrimes_.emplace_back(p);
+      this->smallNext_.emplace_back(start);
+    } else if (start <= high) {
+      this->schedule({p, start});
+    }
+  }
+}
+
+void BucketSieve::schedule(const Entry &entry) {
+  const uint64_t block = (entry.multiple - this->start_) / (2ull * this->blockSize_);
+  this->buckets_[block % this->buckets_.size()].push_back(entry);
+}
+
+bool BucketSieve::next(std::vector<uint64_t> &primes) {
+  primes.clear();
+
+  if (this->finished_)
+    return false;
+
+  if (this->current_ <= 2 && this->low_ <= 2 && this->high_ >= 2)
+    primes.emplace_back(2);
+
+  const uint64_t end = std::min<uint64_t>(this->high_ + 1, this->current_ + 2ull * this->blockSize_);
+  const auto count = static_cast<uint32_t>((end - this->current_) / 2);
+  std::fill(this->block_.begin(), this->block_.begin() + count, 1);
+
+  for (size_t k = 0; k < this->smallPrimes_.size(); ++k) {
+    const uint64_t step = 2ull * this->smallPrimes_[k];
+    uint64_t multiple = this->smallNext_[k];
+
+    for (; multiple < end; multiple += step)
+      this->block_[(multiple - this->current_) / 2] = 0;
+
+    this->smallNext_[k] = multiple;
+  }
+
+  // Bucket is taken out, because its entries go to other buckets, or back to it
+  this->bucket_.clear();
+  this->bucket_.swap(this->buckets_[this->blockNumber_ % this->buckets_.size()]);
+
+  for (auto entry: this->bucket_) {
+    if (entry.multiple < end) {
+      this->block_[(entry.multiple - this->current_) / 2] = 0;
+      entry.multiple += 2ull * entry.prime;
+    }
+
+    if (entry.multiple <= this->high_)
+      this->schedule(entry);
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint64_t number = this->current_ + 2ull * i + 1;
+    if (this->block_[i] && number >= this->low_ && number > 1)
+      primes.emplace_back(number);
+  }
+
+  this->current_ += 2ull * this->blockSize_;
+  ++this->blockNumber_;
+  this->finished_ = end > this->high_;
+  return true;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file BucketSieve.h
+ * Segmented sieve of Eratosthenes with buckets for large primes.
+ * Prime, which is larger then block, crosses off at most one number in block,
+ * so it's kept in bucket of the block, where its next odd multiple is, and touched only there.
+ * It's worth for high windows, where most of sieving primes miss every block.
+ * @href http://sweet.ua.pt/tos/software/prime_sieve.html
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_BUCKETSIEVE_H
+#define OOP_4_AND_5_BUCKETSIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+class BucketSieve final {
+
+ public:
+  // Bytes in one block, every byte is one odd number
+  static const uint32_t defaultBlockSize = 1u << 18;
+
+  BucketSieve(uint64_t low, uint64_t high, uint32_t blockSize = defaultBlockSize);
+  BucketSieve(const BucketSieve &) = delete;
+  BucketSieve &operator=(const BucketSieve &) = delete;
+
+  // Primes of next block in ascending order. Return false, if whole range was sieved.
+  bool next(std::vector<uint64_t> &primes);
+
+ private:
+  struct Entry {
+    uint32_t prime;
+    uint64_t multiple;
+  };
+
+  // Put entry to bucket of block, which has its multiple
+  void schedule(const Entry &entry);
+
+  uint64_t low_;
+  uint64_t high_;
+  uint32_t blockSize_;
+
+  // Next block starts from this even number
+  uint64_t current_;
+  uint64_t start_;
+  uint64_t blockNumber_;
+  bool finished_;
+
+  // Primes not larger then block are processed in every block
+  std::vector<uint32_t> smallPrimes_;
+  std::vector<uint64_t> smallNext_;
+
+  // Ring of buckets, buckets_[k % size] has entries of block k. Entry, which is
+  // too far for ring, waits in bucket and is moved, when ring comes to it again.
+  std::vector<std::vector<Entry> > buckets_;
+  std::vector<Entry> bucket_;
+
+  // block_[i] is 1, if current_ + 2 * i + 1 can be prime
+  std::vector<uint8_t> block_;
+};
+
+#endif //OOP_4_AND_5_BUCKETSIEVE_H
@@ -11,7 +11,27 @@
 #include <iostream>
 
 #include "Factorizer.h"
+#include <NativeFactorizer/NativeFactorizer.h>
 
+namespace {
+
+  // Numbers, which fit in 64 bits, are factorized without GMP
+  bool toNative(const mpz_class &x, uint64_t &value) {
+    if (sgn(x) < 0 || mpz_sizeinbase(x.get_mpz_t(), 2) > 64)
+      return false;
+
+    value = 0;
+    mpz_export(&value, nullptr, -1, sizeof(value), 0, 0, x.get_mpz_t());
+    return true;
+  }
+
+  mpz_class fromNative(uint64_t value) {
+    mpz_class x;
+    mpz_import(x.get_mpz_t(), 1, -1, sizeof(value), 0, 0, &value);
+    return x;
+  }
+
+}
 
 std::vector<mpz_class>* Factorizer::getFactorFromStorage(const mpz_class &n) {
   const auto temp = this->storage_.find(n);
@@ -51,6 +71,15 @@ std::vector<mpz_class> Factorizer::factorize(const mpz_class &x) {
     if (this->addExistDividerNumbers(solve, number))
       continue;
 
+    // Small numbers and cofactors are factorized completely without Quadratic Sieve
+    uint64_t value = 0;
+    if (toNative(number, value) && value > 1) {
+      for (const auto &factor: NativeFactorizer::factorize(value)) {
+        solve.emplace_back(fromNative(factor));
+      }
+      continue;
+    }
+
     try {
       const mpz_class divider = sieve_.factorNumber(number);
       if (divider == 1 || mpz_cmp(divider.get_mpz_t(), number.get_mpz_t()) == 0) {
@@ -7,9 +7,124 @@
  * @version 1.0
  */
 #include <MathFunctions/MathFunctions.h>
+#include <algorithm>
 #include <cmath>
+#include <limits>
 #include <map>
 
+namespace {
+
+  // Odd square-free multipliers for Knuth-Schroeppel function
+  const uint32_t multipliers[] = {1, 3, 5, 7, 11, 13, 15, 17, 19, 21, 23, 29, 31, 33, 35, 37, 39,
+                                  41, 43, 47, 51, 53, 55, 57, 59, 61, 65, 67, 69, 71, 73};
+
+  /*
+   * Algorithm from
+   * Cohen H. A course in computational algebraic number theory, 1993.
+   * Page 33.
+   */
+  uint32_t tonelli(uint32_t n, const MathFunctions::Barrett &barrett) {
+    const uint32_t p = barrett.modulus();
+
+    uint64_t q = p - 1;
+    uint32_t s = 0;
+
+    while (q % 2 == 0) {
+      q /= 2;
+      ++s;
+    }
+
+    uint32_t z = 2;
+    while (barrett.power(z, (p - 1) / 2) != p - 1)
+      ++z;
+
+    uint32_t c = barrett.power(z, q);
+    uint32_t r = barrett.power(n, (q + 1) / 2);
+    uint32_t t = barrett.power(n, q);
+    uint32_t m = s;
+
+    while (t != 1) {
+      uint32_t t2 = barrett.multiply(t, t);
+      uint32_t i = 1;
+      while (i < m && t2 != 1) {
+        t2 = barrett.multiply(t2, t2);
+        ++i;
+      }
+
+      // b = c^(2^(m - i - 1))
+      uint32_t b = c;
+      for (uint32_t j = i + 1; j < m; ++j) {
+        b = barrett.multiply(b, b);
+      }
+
+      r = barrett.multiply(r, b);
+      c = barrett.multiply(b, b);
+      t = barrett.multiply(t, c);
+      m = i;
+    }
+
+    return r;
+  }
+
+  /**
+   * Square root modulo prime with explicit formulas for p = 3 (mod 4) and p = 5 (mod 8).
+   * Only primes p = 1 (mod 8) need Tonelli-Shanks algorithm.
+   */
+  uint32_t sqrtModPrime(uint32_t n, const MathFunctions::Barrett &barrett) {
+    const uint32_t p = barrett.modulus();
+
+    if (p == 2 || n == 0)
+      return n;
+
+    if (p % 4 == 3)
+      return barrett.power(n, (p + 1) / 4);
+
+    if (p % 8 == 5) {
+      // Atkin's formula: v = (2n)^((p - 5) / 8), i = 2nv^2, root = nv(i - 1)
+      const uint32_t twoN = barrett.reduce(2ull * n);
+      const uint32_t v = barrett.power(twoN, (p - 5) / 8);
+      const uint32_t i = barrett.multiply(twoN, barrett.multiply(v, v));
+      return barrett.multiply(barrett.multiply(n, v), i - 1);
+    }
+
+    return tonelli(n, barrett);
+  }
+
+}
+
+MathFunctions::Montgomery::Montgomery(uint64_t n) : n_(n), inverse_(n) {
+  // Newton's iteration doubles count of right bits of n^(-1) mod 2^64
+  for (int i = 0; i < 5; ++i)
+    this->inverse_ *= 2 - n * this->inverse_;
+
+  this->one_ = (0 - n) % n;
+  this->r2_ = static_cast<uint64_t>(static_cast<unsigned __int128>(this->one_) * this->one_ % n);
+}
+
+uint64_t MathFunctions::Montgomery::power(uint64_t x, uint64_t y) const {
+  uint64_t result = this->one_;
+  while (y > 0) {
+    if (y & 1)
+      result = this->multiply(result, x);
+    x = this->multiply(x, x);
+    y >>= 1;
+  }
+  return result;
+}
+
+MathFunctions::Barrett::Barrett(uint32_t p) : p_(p), m_(std::numeric_limits<uint64_t>::max() / p) {}
+
+uint32_t MathFunctions::Barrett::power(uint32_t x, uint64_t y) const {
+  uint32_t result = this->reduce(1);
+  x = this->reduce(x);
+  while (y > 0) {
+    if (y & 1)
+      result = this->multiply(result, x);
+    x = this->multiply(x, x);
+    y >>= 1;
+  }
+  return result;
+}
 
 int64_t MathFunctions::simple_legendre(const uint64_t &nl, const uint64_t &pl) {
   auto ans = MathFunctions::pow_mod(nl, (pl - 1) / 2, pl);
@@ -17,85 +132,134 @@ int64_t MathFunctions::simple_legendre(const uint64_t &nl, const uint64_t &pl) {
 }
 
 uint64_t MathFunctions::pow_mod(uint64_t x, uint64_t y, uint64_t z) {
-  uint64_t result = 1;
+  uint64_t result = 1 % z;
+  x %= z;
   while (y > 0) {
     if (y & 1) // For each set bit in exponent.
-      result = (result * x) % z; // Multiply result by x_^2^i.
+      result = mul_mod(result, x, z); // Multiply result by x_^2^i.
     y >>= 1;
-    x = (x * x) % z; // Square the base.
+    x = mul_mod(x, x, z); // Square the base.
   }
   return result;
 }
 
-/*
- * Algorithm from
- * Cohen H. A course in computational algebraic number theory, 1993.
- * Page 33.
+/**
+ * Get x^(-1) mod z with help of extended Euclidean algorithm.
+ * x and z must be coprime.
  */
-std::pair<uint32_t, uint32_t> MathFunctions::Shanks_Tonelli(const uint32_t &n, const uint32_t &p) {
-  if (p == 2){
-    return std::make_pair(n, n);
-  }
+uint64_t MathFunctions::inverse_mod(uint64_t x, uint64_t z) {
+  int64_t prev = 0;
+  int64_t curr = 1;
+  uint64_t a = z;
+  uint64_t b = x % z;
 
-  uint64_t q = p - 1;
-  uint64_t s = 0;
+  while (b != 0) {
+    const uint64_t q = a / b;
+    const int64_t temp = prev - static_cast<int64_t>(q) * curr;
+    prev = curr;
+    curr = temp;
 
-  while (q % 2 == 0) {
-    q /= 2;
-    ++s;
+    const uint64_t r = a - q * b;
+    a = b;
+    b = r;
   }
 
-  uint64_t z = 2;
-  while (simple_legendre(z, p) != -1)
-    ++z;
-
-  uint64_t c = MathFunctions::pow_mod(z, q, p);
-  uint64_t r = MathFunctions::pow_mod(n, (q + 1) / 2, p);
-  uint64_t t = MathFunctions::pow_mod(n, q, p);
-  uint64_t m = s;
-  uint64_t t2 = 0;
-
-  while ((t - 1) % p != 0) {
-    t2 = (t * t) % p;
-    uint32_t i;
-    for (i = 1; i < m; i++) {
-      if ((t2 - 1) % p == 0)
-        break;
-      t2 = (t2 * t2) % p;
-    }
+  return prev < 0 ? static_cast<uint64_t>(prev + static_cast<int64_t>(z)) : static_cast<uint64_t>(prev);
+}
 
-    const uint64_t temp = (m - i - 1);
-    uint64_t b = MathFunctions::pow_mod(c, std::pow(2, temp), p);
-    r = (r * b) % p;
-    c = (b * b) % p;
-    t = (t * c) % p;
-    m = i;
+uint64_t MathFunctions::mul_mod(uint64_t x, uint64_t y, uint64_t z) {
+  return static_cast<uint64_t>(static_cast<unsigned __int128>(x) * y % z);
+}
+
+std::pair<uint32_t, uint32_t> MathFunctions::Shanks_Tonelli(const uint32_t &n, const uint32_t &p) {
+  if (p == 2){
+    return std::make_pair(n, n);
   }
 
+  const Barrett barrett(p);
+  const uint32_t solve = n % p == 0 ? 0 : tonelli(barrett.reduce(n), barrett);
+  return std::make_pair(solve, solve == 0 ? 0 : p - solve);
+}
+
+void MathFunctions::sqrt_mod(const mpz_class &n, const std::vector<uint32_t> &primes, std::vector<uint32_t> &roots) {
+  roots.resize(primes.size());
 
-  const auto solve = static_cast<uint32_t>(r);
-  return std::make_pair(solve, p - solve);
+  for (size_t i = 0; i < primes.size(); ++i) {
+    const Barrett barrett(primes[i]);
+    roots[i] = sqrtModPrime(static_cast<uint32_t>(mpz_fdiv_ui(n.get_mpz_t(), primes[i])), barrett);
+  }
 }
 
+void MathFunctions::inverse_mod(const mpz_class &x, const std::vector<uint32_t> &primes,
+                                std::vector<uint32_t> &inverses) {
+  inverses.resize(primes.size());
 
+  for (size_t i = 0; i < primes.size(); ++i) {
+    const uint64_t residue = mpz_fdiv_ui(x.get_mpz_t(), primes[i]);
+    inverses[i] = residue == 0 ? 0 : static_cast<uint32_t>(inverse_mod(residue, primes[i]));
+  }
+}
 
 /**
  *
  * Get result of formula:
  *     if y < 0: return (x % y - y) % y
  *     else: return (x % y + y) % y
+ * It is remainder of floor division by |y|.
  */
 uint32_t MathFunctions::mod(const mpz_class &x, const mpz_class &y) {
-  mpz_class result;
-  mpz_mod(result.get_mpz_t(), x.get_mpz_t(), y.get_mpz_t());
+  return static_cast<uint32_t>(mpz_fdiv_ui(x.get_mpz_t(), mpz_get_ui(y.get_mpz_t())));
+}
 
-  if (mpz_cmp_ui(y.get_mpz_t(), 0) < 0) {
-    mpz_sub(result.get_mpz_t(), result.get_mpz_t(), y.get_mpz_t());
-  } else{
-    mpz_add(result.get_mpz_t(), result.get_mpz_t(), y.get_mpz_t());
-  }
+/**
+ * f(k) = -log(k) / 2 + sum g(p, kn) * log(p) estimates, how much of log|Q| is expected from small primes:
+ *     g(2, kn) = 2, 1 or 1/2 for kn = 1, 5 or 3, 7 (mod 8);
+ *     g(p, kn) = 2 / (p - 1), if kn is quadratic residue modulo odd p, else 0;
+ *     g(p, kn) = 1 / p, if p divides k: such prime is in factor base and has one root.
+ * Silverman R. The multiple polynomial quadratic sieve, 1987.
+ */
+uint32_t MathFunctions::knuth_schroeppel(const mpz_class &n, const std::vector<uint32_t> &primes) {
+  const auto n8 = static_cast<uint32_t>(mpz_fdiv_ui(n.get_mpz_t(), 8));
 
-  mpz_mod(result.get_mpz_t(), result.get_mpz_t(), y.get_mpz_t());
+  std::vector<uint32_t> residues;
+  for (const auto &p: primes)
+    residues.emplace_back(static_cast<uint32_t>(mpz_fdiv_ui(n.get_mpz_t(), p)));
 
-  return result.get_ui();
-}
\ No newline at end of file
+  uint32_t best = 1;
+  double bestScore = -std::numeric_limits<double>::infinity();
+
+  for (const auto &k: multipliers) {
+    // Multiplier, which has common prime with n, is skipped
+    bool coprime = true;
+    for (uint32_t i = 0; i < primes.size() && primes[i] <= k; ++i)
+      coprime = coprime && (k % primes[i] != 0 || residues[i] != 0);
+    if (!coprime)
+      continue;
+
+    double score = -std::log(k) / 2;
+
+    switch (k * n8 % 8) {
+      case 1: score += 2 * std::log(2); break;
+      case 5: score += std::log(2); break;
+      default: score += std::log(2) / 2; break;
+    }
+
+    for (uint32_t i = 0; i < primes.size(); ++i) {
+      const uint64_t p = primes[i];
+      if (p == 2)
+        continue;
+
+      if (k % p == 0)
+        score += std::log(p) / p;
+      else if (simple_legendre(residues[i] * (k % p) % p, p) == 1)
+        score += 2 * std::log(p) / (p - 1);
+    }
+
+    if (score > bestScore) {
+      bestScore = score;
+      best = k;
+    }
+  }
+
+  return best;
+}
@@ -9,16 +9,102 @@
 #ifndef OOP_4_AND_5_MATHFUNCTIONS_H
 #define OOP_4_AND_5_MATHFUNCTIONS_H
 
+#include <cstdint>
 #include <vector>
 #include <gmpxx.h>
 
 namespace MathFunctions {
 
+  /**
+   * Context for many multiplications modulo the same odd n < 2^64.
+   * Numbers are kept in Montgomery form x * 2^64 mod n, so multiplication doesn't need division.
+   */
+  class Montgomery final {
+   public:
+    explicit Montgomery(uint64_t n);
+
+    inline uint64_t reduce(unsigned __int128 t) const {
+      const auto m = static_cast<uint64_t>(t) * this->inverse_;
+      const auto high = static_cast<uint64_t>(t >> 64);
+      const auto mn = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * this->n_) >> 64);
+      return high >= mn ? high - mn : high - mn + this->n_;
+    }
+
+    inline uint64_t multiply(uint64_t x, uint64_t y) const {
+      return this->reduce(static_cast<unsigned __int128>(x) * y);
+    }
+
+    inline uint64_t add(uint64_t x, uint64_t y) const {
+      const uint64_t s = x + y;
+      return (s < x || s >= this->n_) ? s - this->n_ : s;
+    }
+
+    inline uint64_t toForm(uint64_t x) const {
+      return this->multiply(x % this->n_, this->r2_);
+    }
+
+    inline uint64_t fromForm(uint64_t x) const {
+      return this->reduce(x);
+    }
+
+    uint64_t power(uint64_t x, uint64_t y) const;
+
+    inline uint64_t one() const { return this->one_; }
+    inline uint64_t modulus() const { return this->n_; }
+
+   private:
+    uint64_t n_;
+    uint64_t inverse_; // n^(-1) mod 2^64
+    uint64_t one_;     // 2^64 mod n
+    uint64_t r2_;      // 2^128 mod n
+  };
+
+  /**
+   * Context for reduction modulo p < 2^32.
+   * Quotient is got from multiplication by precomputed 2^64 / p.
+   */
+  class Barrett final {
+   public:
+    explicit Barrett(uint32_t p);
+
+    inline uint32_t reduce(uint64_t x) const {
+      const auto q = static_cast<uint64_t>((static_cast<unsigned __int128>(x) * this->m_) >> 64);
+      uint64_t r = x - q * this->p_;
+      if (r >= this->p_)
+        r -= this->p_;
+      return static_cast<uint32_t>(r);
+    }
+
+    inline uint32_t multiply(uint32_t x, uint32_t y) const {
+      return this->reduce(static_cast<uint64_t>(x) * y);
+    }
+
+    uint32_t power(uint32_t x, uint64_t y) const;
+
+    inline uint32_t modulus() const { return this->p_; }
+
+   private:
+    uint64_t p_;
+    uint64_t m_;
+  };
+
   std::pair<uint32_t, uint32_t> Shanks_Tonelli(const uint32_t &n, const uint32_t &p);
   int64_t simple_legendre(const uint64_t &nl, const uint64_t &pl);
   uint64_t pow_mod(uint64_t x, uint64_t y, uint64_t z);
+  uint64_t inverse_mod(uint64_t x, uint64_t z);
+  uint64_t mul_mod(uint64_t x, uint64_t y, uint64_t z);
   uint32_t mod(const mpz_class& x, const mpz_class& y);
 
+  // Square root of n modulo every prime (n must be quadratic residue)
+  void sqrt_mod(const mpz_class &n, const std::vector<uint32_t> &primes, std::vector<uint32_t> &roots);
+
+  // x^(-1) modulo every prime, 0 for primes which divide x
+  void inverse_mod(const mpz_class &x, const std::vector<uint32_t> &primes, std::vector<uint32_t> &inverses);
+
+  // Small square-free multiplier k, so k * n has many small primes in factor base.
+  // Multipliers are scored by Knuth-Schroeppel function over given primes.
+  uint32_t knuth_schroeppel(const mpz_class &n, const std::vector<uint32_t> &primes);
+
 }
 
 #endif //OOP_4_AND_5_MATHFUNCTIONS_H
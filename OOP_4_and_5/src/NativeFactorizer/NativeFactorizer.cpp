@@ -0,0 +1,268 @@
+/**
+ * @file NativeFactorizer.cpp
+ * Factorization of numbers, which fit in 64 bits, without GMP.
+ * Description:
+ * https://en.wikipedia.org/wiki/Shanks%27s_square_forms_factorization
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 11.12.2017
+ * @version 1.0
+ */
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <MathFunctions/MathFunctions.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  // Numbers are divided by all odd numbers less then it before rho
+  const uint64_t trialDivisionBound = 1000;
+
+  // Rho gives up after so many iterations for one constant
+  const uint64_t maxRhoIterations = 1u << 22;
+  const uint64_t rhoBlockSize = 128;
+
+  // Constants, which are tried by one call of rho, and all constants, which are tried before trial division
+  const uint64_t rhoConstants = 15;
+  const uint64_t maxRhoConstant = 256;
+
+  // Bases of Miller-Rabin test, which are enough for all n < 2^64
+  const uint64_t millerRabinBases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+
+  const uint64_t squfofMultipliers[] = {1, 3, 5, 7, 11, 3 * 5, 3 * 7, 3 * 11, 5 * 7, 5 * 11, 7 * 11,
+                                        3 * 5 * 7, 3 * 5 * 11, 3 * 7 * 11, 5 * 7 * 11, 3 * 5 * 7 * 11};
+
+  uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+      const uint64_t r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  }
+
+  uint64_t isqrt(uint64_t n) {
+    auto r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && (r > UINT32_MAX || r * r > n))
+      --r;
+    while (r < UINT32_MAX && (r + 1) * (r + 1) <= n)
+      ++r;
+    return r;
+  }
+
+  // Smallest divider of odd composite n, which has no dividers less then trialDivisionBound
+  uint64_t trial_division(uint64_t n) {
+    const uint64_t root = isqrt(n);
+    for (uint64_t d = trialDivisionBound | 1; d <= root; d += 2) {
+      if (n % d == 0)
+        return d;
+    }
+    return n;
+  }
+
+}
+
+bool NativeFactorizer::is_prime(uint64_t n) {
+  if (n < 2)
+    return false;
+
+  for (uint64_t p: {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37}) {
+    if (n % p == 0)
+      return n == p;
+  }
+
+  if (n < 41 * 41)
+    return true;
+
+  uint64_t d = n - 1;
+  uint32_t s = 0;
+  while ((d & 1) == 0) {
+    d >>= 1;
+    ++s;
+  }
+
+  const MathFunctions::Montgomery mont(n);
+  const uint64_t minusOne = n - mont.one();
+
+  for (const auto &base: millerRabinBases) {
+    if (base % n == 0)
+      continue;
+
+    uint64_t x = mont.power(mont.toForm(base), d);
+    if (x == mont.one() || x == minusOne)
+      continue;
+
+    bool composite = true;
+    for (uint32_t i = 1; i < s && composite; ++i) {
+      x = mont.multiply(x, x);
+      composite = x != minusOne;
+    }
+
+    if (composite)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Pollard's rho algorithm with Brent's cycle detection.
+ * All values are in Montgomery form, product of differences is checked with gcd once per block.
+ */
+uint64_t NativeFactorizer::pollard_brent(uint64_t n, uint64_t firstConstant) {
+  const MathFunctions::Montgomery mont(n);
+
+  for (uint64_t c = firstConstant; c < firstConstant + rhoConstants; ++c) {
+    const uint64_t constant = mont.toForm(c);
+    uint64_t y = mont.toForm(2);
+    uint64_t x = y;
+    uint64_t ys = y;
+    uint64_t q = mont.one();
+    uint64_t g = 1;
+
+    for (uint64_t r = 1; g == 1 && r <= maxRhoIterations; r <<= 1) {
+      x = y;
+      for (uint64_t i = 0; i < r; ++i)
+        y = mont.add(mont.multiply(y, y), constant);
+
+      for (uint64_t k = 0; k < r && g == 1; k += rhoBlockSize) {
+        ys = y;
+        for (uint64_t i = 0; i < std::min(rhoBlockSize, r - k); ++i) {
+          y = mont.add(mont.multiply(y, y), constant);
+          q = mont.multiply(q, x > y ? x - y : y - x);
+        }
+        g = gcd(q, n);
+      }
+    }
+
+    // Backtrack, if all factors were collected in one block
+    if (g == n) {
+      do {
+        ys = mont.add(mont.multiply(ys, ys), constant);
+        g = gcd(x > ys ? x - ys : ys - x, n);
+      } while (g == 1);
+    }
+
+    if (g != 1 && g != n)
+      return g;
+  }
+
+  return n;
+}
+
+/**
+ * Shanks's square forms factorization.
+ * It walks continued fraction of sqrt(k * n) until square form is found,
+ * then goes back along reverse cycle to ambiguous form, which gives divider.
+ */
+uint64_t NativeFactorizer::squfof(uint64_t n) {
+  const uint64_t root = isqrt(n);
+  if (root * root == n)
+    return root;
+
+  for (const auto &multiplier: squfofMultipliers) {
+    if (n > UINT64_MAX / multiplier)
+      break;
+
+    const uint64_t D = multiplier * n;
+    const uint64_t P0 = isqrt(D);
+    uint64_t P = P0;
+    uint64_t prevP = P0;
+    uint64_t prevQ = 1;
+    uint64_t Q = D - P0 * P0;
+    if (Q == 0)
+      continue;
+
+    const auto bound = static_cast<uint64_t>(6 * std::sqrt(2 * std::sqrt(static_cast<double>(D))));
+    uint64_t r = 0;
+    uint64_t i = 2;
+
+    for (; i < bound; ++i) {
+      const uint64_t b = (P0 + P) / Q;
+      P = b * Q - P;
+      const uint64_t q = Q;
+      Q = prevQ + b * (prevP - P);
+      r = isqrt(Q);
+      if ((i & 1) == 0 && r * r == Q)
+        break;
+      prevQ = q;
+      prevP = P;
+    }
+
+    if (i >= bound || r == 0)
+      continue;
+
+    uint64_t b = (P0 - P) / r;
+    P = b * r + P;
+    prevP = P;
+    prevQ = r;
+    Q = (D - prevP * prevP) / prevQ;
+    if (Q == 0)
+      continue;
+
+    for (i = 0; i < bound; ++i) {
+      b = (P0 + P) / Q;
+      prevP = P;
+      P = b * Q - P;
+      const uint64_t q = Q;
+      Q = prevQ + b * (prevP - P);
+      prevQ = q;
+      if (P == prevP)
+        break;
+    }
+
+    const uint64_t g = gcd(n, prevQ);
+    if (g != 1 && g != n)
+      return g;
+  }
+
+  return n;
+}
+
+std::vector<uint64_t> NativeFactorizer::factorize(uint64_t n) {
+  std::vector<uint64_t> factors;
+
+  while (n > 1 && (n & 1) == 0) {
+    factors.emplace_back(2);
+    n >>= 1;
+  }
+
+  for (uint64_t d = 3; d < trialDivisionBound && d * d <= n; d += 2) {
+    while (n % d == 0) {
+      factors.emplace_back(d);
+      n /= d;
+    }
+  }
+
+  std::vector<uint64_t> stack;
+  if (n > 1)
+    stack.emplace_back(n);
+
+  while (!stack.empty()) {
+    const uint64_t number = stack.back();
+    stack.pop_back();
+
+    if (number < trialDivisionBound * trialDivisionBound || is_prime(number)) {
+      factors.emplace_back(number);
+      continue;
+    }
+
+    uint64_t divider = pollard_brent(number);
+    if (divider == number)
+      divider = squfof(number);
+
+    for (uint64_t c = 1 + rhoConstants; divider == number && c < maxRhoConstant; c += rhoConstants)
+      divider = pollard_brent(number, c);
+
+    // Composite number is never returned as prime, trial division always finds divider
+    if (divider == number)
+      divider = trial_division(number);
+
+    stack.emplace_back(divider);
+    stack.emplace_back(number / divider);
+  }
+
+  std::sort(factors.begin(), factors.end());
+  return factors;
+}
@@ -0,0 +1,32 @@
+/**
+ * @file NativeFactorizer.h
+ * Factorization of numbers, which fit in 64 bits, without GMP:
+ *     - deterministic Miller-Rabin test;
+ *     - Pollard's rho with Brent's cycle detection in Montgomery form;
+ *     - SQUFOF, if rho hasn't found divider.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 11.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_NATIVEFACTORIZER_H
+#define OOP_4_AND_5_NATIVEFACTORIZER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace NativeFactorizer {
+
+  bool is_prime(uint64_t n);
+
+  // n must be odd composite number. Return non-trivial divider of n, or n if it wasn't found.
+  // Rho tries several constants of polynomial x^2 + c, starting from firstConstant.
+  uint64_t pollard_brent(uint64_t n, uint64_t firstConstant = 1);
+  uint64_t squfof(uint64_t n);
+
+  // Prime factors of n in ascending order (with multiplicity)
+  std::vector<uint64_t> factorize(uint64_t n);
+
+}
+
+#endif //OOP_4_AND_5_NATIVEFACTORIZER_H
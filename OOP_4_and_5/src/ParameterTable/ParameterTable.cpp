@@ -0,0 +1,180 @@
+/**
+ * @file ParameterTable.cpp
+ * Process-wide table of sieve parameters by count of digits of N.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 18.12.2017
+ * @version 1.0
+ */
+#include <ParameterTable/ParameterTable.h>
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+  const char header[] = "# digits factorBaseSize halfInterval thresholdFactor largePrimeMultiplier largePrimes";
+
+  // operator>> into unsigned type takes "-5" and wraps it, so field is read as signed number
+  std::istream &readUnsigned(std::istream &in, uint32_t &value) {
+    long long field = 0;
+    if (in >> field) {
+      if (field < 0 || field > std::numeric_limits<uint32_t>::max())
+        in.setstate(std::ios::failbit);
+      else
+        value = static_cast<uint32_t>(field);
+    }
+    return in;
+  }
+
+}
+
+const uint32_t ParameterTable::siqsMinDigits;
+const uint32_t ParameterTable::maxFactorBaseSize;
+const uint32_t ParameterTable::maxHalfInterval;
+const uint32_t ParameterTable::maxLargePrimeMultiplier;
+
+ParameterTable::ParameterTable() : rows_(defaults()) {}
+
+ParameterTable &ParameterTable::instance() {
+  static ParameterTable table;
+  return table;
+}
+
+const std::vector<ParameterTable::Parameters> &ParameterTable::defaults() {
+  static const std::vector<Parameters> table = {
+      {10, 40, 16384, 1.0, 30, 1},
+      {14, 60, 16384, 1.0, 30, 1},
+      {18, 100, 16384, 1.0, 30, 1},
+      {20, 120, 16384, 1.8, 30, 1},
+      {30, 300, 32768, 2.0, 40, 1},
+      {40, 700, 65536, 2.2, 50, 1},
+      {50, 1500, 65536, 2.5, 60, 2},
+      {60, 3000, 98304, 2.7, 80, 2},
+      {70, 6000, 131072, 2.8, 100, 2},
+      {80, 12000, 196608, 2.9, 120, 2},
+      {90, 25000, 262144, 3.0, 150, 2},
+      {100, 50000, 327680, 3.1, 200, 2}
+  };
+  return table;
+}
+
+ParameterTable::Parameters ParameterTable::get(uint32_t digits) const {
+  std::lock_guard<std::mutex> lg(this->m_);
+  const auto &rows = this->rows_;
+
+  if (digits <= rows.front().digits)
+    return rows.front();
+
+  if (digits >= rows.back().digits)
+    return rows.back();
+
+  // Linear interpolation between two nearest rows of table
+  size_t i = 1;
+  while (rows[i].digits < digits)
+    ++i;
+
+  const Parameters &low = rows[i - 1];
+  const Parameters &high = rows[i];
+  const double t = static_cast<double>(digits - low.digits) / (high.digits - low.digits);
+
+  Parameters result{};
+  result.digits = digits;
+  // Tuned table can have smaller factor base in the higher row, so difference is signed
+  result.factorBaseSize = static_cast<uint32_t>(low.factorBaseSize +
+      t * (static_cast<double>(high.factorBaseSize) - low.factorBaseSize));
+  result.halfInterval = low.halfInterval;
+  result.thresholdFactor = low.thresholdFactor + t * (high.thresholdFactor - low.thresholdFactor);
+  result.largePrimeMultiplier = low.largePrimeMultiplier;
+  result.largePrimes = low.largePrimes;
+
+  return result;
+}
+
+std::vector<ParameterTable::Parameters> ParameterTable::rows() const {
+  std::lock_guard<std::mutex> lg(this->m_);
+  return this->rows_;
+}
+
+void ParameterTable::setRows(const std::vector<Parameters> &rows) {
+  check(rows);
+
+  std::lock_guard<std::mutex> lg(this->m_);
+  this->rows_ = rows;
+}
+
+bool ParameterTable::load(const std::string &fileName) {
+  std::ifstream in(fileName);
+  if (!in.is_open())
+    return false;
+
+  this->setRows(read(in));
+  return true;
+}
+
+void ParameterTable::save(const std::string &fileName) const {
+  std::ofstream out(fileName);
+  if (!out.is_open())
+    throw std::invalid_argument("Can't open file " + fileName);
+
+  write(out, this->rows());
+}
+
+std::vector<ParameterTable::Parameters> ParameterTable::read(std::istream &in) {
+  std::vector<Parameters> rows;
+  std::string line;
+
+  while (std::getline(in, line)) {
+    const auto start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#')
+      continue;
+
+    std::istringstream stream(line);
+    Parameters row{};
+    std::string rest;
+
+    readUnsigned(stream, row.digits);
+    readUnsigned(stream, row.factorBaseSize);
+    readUnsigned(stream, row.halfInterval);
+    stream >> row.thresholdFactor;
+    readUnsigned(stream, row.largePrimeMultiplier);
+    readUnsigned(stream, row.largePrimes);
+
+    if (stream.fail() || (stream >> rest))
+      throw std::invalid_argument("Wrong row of parameter table: " + line);
+
+    rows.emplace_back(row);
+  }
+
+  check(rows);
+  return rows;
+}
+
+void ParameterTable::write(std::ostream &out, const std::vector<Parameters> &rows) {
+  out << header << '\n';
+
+  for (const auto &row: rows) {
+    out << row.digits << ' ' << row.factorBaseSize << ' ' << row.halfInterval << ' '
+        << row.thresholdFactor << ' ' << row.largePrimeMultiplier << ' ' << row.largePrimes << '\n';
+  }
+}
+
+void ParameterTable::check(const std::vector<Parameters> &rows) {
+  if (rows.empty())
+    throw std::invalid_argument("Parameter table is empty.");
+
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const Parameters &row = rows[i];
+
+    if (i > 0 && rows[i - 1].digits >= row.digits)
+      throw std::invalid_argument("Rows of parameter table must be sorted by digits.");
+
+    if (row.factorBaseSize == 0 || row.factorBaseSize > maxFactorBaseSize ||
+        row.halfInterval == 0 || row.halfInterval > maxHalfInterval || row.thresholdFactor <= 0 ||
+        row.largePrimeMultiplier == 0 || row.largePrimeMultiplier > maxLargePrimeMultiplier ||
+        row.largePrimes < 1 || row.largePrimes > 2)
+      throw std::invalid_argument("Wrong parameters for " + std::to_string(row.digits) + " digits.");
+  }
+}
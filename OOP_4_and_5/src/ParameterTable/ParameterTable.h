@@ -0,0 +1,82 @@
+/**
+ * @file ParameterTable.h
+ * Process-wide table of sieve parameters by count of digits of N (not kN, which is sieved).
+ * Rows below siqsMinDigits are used by classic sieve, the others by SIQS.
+ * Parameters between two rows are interpolated. Table can be read from text file:
+ *     # digits factorBaseSize halfInterval thresholdFactor largePrimeMultiplier largePrimes
+ *     40 700 65536 2.2 50 1
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 18.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PARAMETERTABLE_H
+#define OOP_4_AND_5_PARAMETERTABLE_H
+
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ParameterTable final {
+
+ public:
+  struct Parameters {
+    uint32_t digits;
+    uint32_t factorBaseSize;
+
+    // SIQS sieves [-M, M) for every polynomial, classic sieve goes by steps of 2M
+    uint32_t halfInterval;
+
+    // Number is candidate, if logs of its primes are less then log|Q| at most on
+    // thresholdFactor * log(max prime of factor base)
+    double thresholdFactor;
+
+    // Bound of large prime is largePrimeMultiplier * (max prime of factor base)
+    uint32_t largePrimeMultiplier;
+
+    // Max count of large primes in partial relation (1 or 2)
+    uint32_t largePrimes;
+  };
+
+  // Numbers with more digits are factorized with help of self-initializing sieve
+  static const uint32_t siqsMinDigits = 22;
+
+  // Bigger values are typos in table, they would make sieve allocate gigabytes
+  static const uint32_t maxFactorBaseSize = 1u << 20;
+  static const uint32_t maxHalfInterval = 1u << 24;
+  static const uint32_t maxLargePrimeMultiplier = 1u << 12;
+
+  static ParameterTable &instance();
+
+  ParameterTable(const ParameterTable &) = delete;
+  ParameterTable &operator=(const ParameterTable &) = delete;
+
+  Parameters get(uint32_t digits) const;
+
+  std::vector<Parameters> rows() const;
+  void setRows(const std::vector<Parameters> &rows);
+
+  // Return false, if file can't be opened. Wrong table throws std::invalid_argument.
+  // Table isn't changed in both cases.
+  bool load(const std::string &fileName);
+  void save(const std::string &fileName) const;
+
+  // Rows must be sorted by digits and have parameters in bounds, otherwise std::invalid_argument is thrown
+  static std::vector<Parameters> read(std::istream &in);
+  static void write(std::ostream &out, const std::vector<Parameters> &rows);
+
+  // Experimentally obtained values
+  static const std::vector<Parameters> &defaults();
+
+ private:
+  ParameterTable();
+
+  static void check(const std::vector<Parameters> &rows);
+
+  mutable std::mutex m_;
+  std::vector<Parameters> rows_;
+};
+
+#endif //OOP_4_AND_5_PARAMETERTABLE_H
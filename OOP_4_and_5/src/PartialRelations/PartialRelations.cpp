@@ -0,0 +1,122 @@
+/**
+ * @file PartialRelations.cpp
+ * Storage of partial relations, which have one or two large primes out of factor base.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 04.12.2017
+ * @version 1.0
+ */
+#include <PartialRelations/PartialRelations.h>
+
+#include <queue>
+
+uint64_t PartialRelations::findRoot(uint64_t vertex) {
+  auto it = this->parent_.find(vertex);
+  if (it == this->parent_.end()) {
+    this->parent_.emplace(vertex, vertex);
+    return vertex;
+  }
+
+  uint64_t root = vertex;
+  while (this->parent_[root] != root)
+    root = this->parent_[root];
+
+  // Path compression
+  while (this->parent_[vertex] != root) {
+    const uint64_t next = this->parent_[vertex];
+    this->parent_[vertex] = root;
+    vertex = next;
+  }
+
+  return root;
+}
+
+bool PartialRelations::addRelation(Relation relation, uint64_t firstPrime, uint64_t secondPrime,
+                                   std::vector<Relation> &fullRelations) {
+  const uint64_t firstRoot = this->findRoot(firstPrime);
+  const uint64_t secondRoot = this->findRoot(secondPrime);
+
+  if (firstRoot != secondRoot) {
+    // New edge of spanning forest
+    const size_t index = this->relations_.size();
+    this->relations_.emplace_back(std::move(relation));
+    this->edges_.emplace_back(firstPrime, secondPrime);
+
+    this->graph_[firstPrime].emplace_back(secondPrime, index);
+    this->graph_[secondPrime].emplace_back(firstPrime, index);
+    this->parent_[firstRoot] = secondRoot;
+
+    return false;
+  }
+
+  // Edge closes cycle: path in forest + new edge
+  std::vector<size_t> cycle;
+  this->findPath(firstPrime, secondPrime, cycle);
+
+  Relation full = this->combineRelations(cycle);
+
+  full.y *= relation.y;
+  mpz_mod(full.y.get_mpz_t(), full.y.get_mpz_t(), this->n_.get_mpz_t());
+  full.factors.insert(full.factors.end(), relation.factors.begin(), relation.factors.end());
+  full.negative ^= relation.negative;
+
+  // Every large prime of cycle appears twice, so square root is product of vertices
+  mpz_class squareProduct = 1;
+  mpz_mul_ui(squareProduct.get_mpz_t(), squareProduct.get_mpz_t(), firstPrime);
+  mpz_mul_ui(squareProduct.get_mpz_t(), squareProduct.get_mpz_t(), secondPrime);
+  for (const auto &i: cycle) {
+    mpz_mul_ui(squareProduct.get_mpz_t(), squareProduct.get_mpz_t(), this->edges_[i].first);
+    mpz_mul_ui(squareProduct.get_mpz_t(), squareProduct.get_mpz_t(), this->edges_[i].second);
+  }
+
+  mpz_sqrt(full.largeFactor.get_mpz_t(), squareProduct.get_mpz_t());
+  mpz_mod(full.largeFactor.get_mpz_t(), full.largeFactor.get_mpz_t(), this->n_.get_mpz_t());
+
+  fullRelations.emplace_back(std::move(full));
+  return true;
+}
+
+void PartialRelations::findPath(uint64_t from, uint64_t to, std::vector<size_t> &path) const {
+  // Breadth-first search in tree: vertex -> (previous vertex, index of relation)
+  std::unordered_map<uint64_t, std::pair<uint64_t, size_t> > previous;
+  std::queue<uint64_t> queue;
+
+  previous.emplace(from, std::make_pair(from, 0));
+  queue.push(from);
+
+  while (!queue.empty() && previous.find(to) == previous.end()) {
+    const uint64_t vertex = queue.front();
+    queue.pop();
+
+    for (const auto &edge: this->graph_.at(vertex)) {
+      if (previous.find(edge.first) == previous.end()) {
+        previous.emplace(edge.first, std::make_pair(vertex, edge.second));
+        queue.push(edge.first);
+      }
+    }
+  }
+
+  path.clear();
+  for (uint64_t vertex = to; vertex != from; vertex = previous[vertex].first) {
+    path.emplace_back(previous[vertex].second);
+  }
+}
+
+Relation PartialRelations::combineRelations(const std::vector<size_t> &cycle) const {
+  Relation full{1, {}, false};
+
+  for (const auto &i: cycle) {
+    const Relation &relation = this->relations_[i];
+
+    full.y *= relation.y;
+    mpz_mod(full.y.get_mpz_t(), full.y.get_mpz_t(), this->n_.get_mpz_t());
+    full.factors.insert(full.factors.end(), relation.factors.begin(), relation.factors.end());
+    full.negative ^= relation.negative;
+  }
+
+  return full;
+}
+
+size_t PartialRelations::size() const {
+  return this->relations_.size();
+}
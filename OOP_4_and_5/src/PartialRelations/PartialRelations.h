@@ -0,0 +1,56 @@
+/**
+ * @file PartialRelations.h
+ * Storage of partial relations, which have one or two large primes out of factor base.
+ * Every partial relation is an edge (p1, p2) of graph, where p2 = 1 for single large prime.
+ * When new edge closes a cycle, all relations of the cycle are multiplied into one full relation,
+ * because every large prime of the cycle appears in even power.
+ * Description:
+ * https://www.iacr.org/archive/eurocrypt2000/1807/18070066-new.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 04.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PARTIALRELATIONS_H
+#define OOP_4_AND_5_PARTIALRELATIONS_H
+
+#include <vector>
+#include <unordered_map>
+#include <gmpxx.h>
+
+#include <Relation/Relation.h>
+
+class PartialRelations final {
+
+ public:
+  explicit PartialRelations(const mpz_class &n) : n_(n) {};
+  PartialRelations(const PartialRelations &) = delete;
+  PartialRelations &operator=(const PartialRelations &) = delete;
+
+  // Add relation with Q = (factor base part) * firstPrime * secondPrime.
+  // Return true, if new full relation was added to fullRelations.
+  bool addRelation(Relation relation, uint64_t firstPrime, uint64_t secondPrime,
+                   std::vector<Relation> &fullRelations);
+
+  size_t size() const;
+
+ private:
+  uint64_t findRoot(uint64_t vertex);
+
+  void findPath(uint64_t from, uint64_t to, std::vector<size_t> &path) const;
+
+  Relation combineRelations(const std::vector<size_t> &cycle) const;
+
+  const mpz_class n_;
+
+  std::vector<Relation> relations_;
+  std::vector<std::pair<uint64_t, uint64_t> > edges_;
+
+  // Spanning forest of graph: vertex -> (vertex, index of relation)
+  std::unordered_map<uint64_t, std::vector<std::pair<uint64_t, size_t> > > graph_;
+
+  // Disjoint set union for connected components
+  std::unordered_map<uint64_t, uint64_t> parent_;
+};
+
+#endif //OOP_4_AND_5_PARTIALRELATIONS_H
@@ -0,0 +1,290 @@
+/**
+ * @file PrimeCache.cpp
+ * File with table of primes, which is kept between runs.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <PrimeCache/PrimeCache.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+  const char magic[8] = {'O', 'O', 'P', 'P', 'R', 'I', 'M', 'E'};
+
+  // File is header, bitmap, gaps, padding to 8 bytes and checkpoints
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t limit;
+    uint64_t bitmapBytes;
+    uint64_t gapBytes;
+    uint64_t checkpointCount;
+    uint64_t primes;
+    int64_t last;
+  };
+
+  const uint64_t checkpointAlignment = alignof(PrimeGaps::Checkpoint);
+
+  uint64_t bitmapBytes(int64_t limit) {
+    return static_cast<uint64_t>(limit / 30 + 1);
+  }
+
+  uint64_t checkpointsOffset(const Header &header) {
+    const uint64_t end = sizeof(Header) + header.bitmapBytes + header.gapBytes;
+    return (end + checkpointAlignment - 1) / checkpointAlignment * checkpointAlignment;
+  }
+
+  uint64_t fileSize(const Header &header) {
+    return checkpointsOffset(header) + header.checkpointCount * sizeof(PrimeGaps::Checkpoint);
+  }
+
+  uint64_t checkpointCount(uint64_t primes) {
+    return (primes + PrimeGaps::checkpointStep - 1) / PrimeGaps::checkpointStep;
+  }
+
+  struct Part {
+    const void *data;
+    size_t size;
+  };
+
+#ifdef _WIN32
+  bool writeAll(HANDLE file, const std::vector<Part> &parts) {
+    for (const auto &part: parts) {
+      const auto *bytes = static_cast<const char *>(part.data);
+      size_t size = part.size;
+      while (size > 0) {
+        DWORD written = 0;
+        const auto chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        if (!WriteFile(file, bytes, chunk, &written, nullptr) || written == 0)
+          return false;
+        bytes += written;
+        size -= written;
+      }
+    }
+    return true;
+  }
+#else
+  bool writeAll(int fd, const std::vector<Part> &parts) {
+    for (const auto &part: parts) {
+      const auto *bytes = static_cast<const char *>(part.data);
+      size_t size = part.size;
+      while (size > 0) {
+        const ssize_t written = ::write(fd, bytes, size);
+        if (written < 0 && errno == EINTR)
+          continue;
+        if (written <= 0)
+          return false;
+        bytes += written;
+        size -= static_cast<size_t>(written);
+      }
+    }
+    return true;
+  }
+#endif
+
+}
+
+PrimeCache::PrimeCache(const std::string &fileName) : data_(nullptr), size_(0) {
+#ifdef _WIN32
+  this->mapping_ = nullptr;
+  this->file_ = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (this->file_ == INVALID_HANDLE_VALUE) {
+    this->file_ = nullptr;
+    return;
+  }
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(this->file_, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+    this->unmap();
+    return;
+  }
+
+  this->mapping_ = CreateFileMappingA(this->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (this->mapping_ == nullptr) {
+    this->unmap();
+    return;
+  }
+
+  this->data_ = static_cast<const uint8_t *>(MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0));
+  this->size_ = static_cast<size_t>(size.QuadPart);
+#else
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+    close(fd);
+    return;
+  }
+
+  void *data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return;
+
+  this->data_ = static_cast<const uint8_t *>(data);
+  this->size_ = static_cast<size_t>(info.st_size);
+#endif
+
+  if (this->data_ == nullptr) {
+    this->unmap();
+    return;
+  }
+
+  Header header;
+  std::memcpy(&header, this->data_, sizeof(Header));
+
+  bool valid = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version &&
+               header.limit >= 0 && header.bitmapBytes == bitmapBytes(header.limit) &&
+               header.checkpointCount == checkpointCount(header.primes) && header.primes <= header.gapBytes + 1 &&
+               header.bitmapBytes <= this->size_ && header.gapBytes <= this->size_ &&
+               header.checkpointCount <= this->size_ && fileSize(header) == this->size_;
+
+  // Last checkpoint must point inside of gaps, other ones are trusted like the gaps themselves
+  if (valid && header.checkpointCount > 0) {
+    PrimeGaps::Checkpoint last;
+    std::memcpy(&last, this->data_ + this->size_ - sizeof(last), sizeof(last));
+    valid = last.offset <= header.gapBytes && last.value <= header.last && header.last <= header.limit;
+  }
+
+  if (!valid)
+    this->unmap();
+}
+
+PrimeCache::~PrimeCache() {
+  this->unmap();
+}
+
+void PrimeCache::unmap() {
+#ifdef _WIN32
+  if (this->data_ != nullptr)
+    UnmapViewOfFile(this->data_);
+  if (this->mapping_ != nullptr)
+    CloseHandle(this->mapping_);
+  if (this->file_ != nullptr)
+    CloseHandle(this->file_);
+
+  this->mapping_ = nullptr;
+  this->file_ = nullptr;
+#else
+  if (this->data_ != nullptr)
+    munmap(const_cast<uint8_t *>(this->data_), this->size_);
+#endif
+
+  this->data_ = nullptr;
+  this->size_ = 0;
+}
+
+bool PrimeCache::empty() const {
+  return this->data_ == nullptr;
+}
+
+long long PrimeCache::limit() const {
+  if (this->empty())
+    return 0;
+
+  Header header;
+  std::memcpy(&header, this->data_, sizeof(Header));
+  return header.limit;
+}
+
+PrimeCache::Table PrimeCache::table() const {
+  if (this->empty())
+    return {0, nullptr, 0, {nullptr, 0, nullptr, 0, 0, 0}};
+
+  Header header;
+  std::memcpy(&header, this->data_, sizeof(Header));
+
+  const uint8_t *bits = this->data_ + sizeof(Header);
+  const uint8_t *gaps = bits + header.bitmapBytes;
+  const auto *checkpoints = reinterpret_cast<const PrimeGaps::Checkpoint *>(this->data_ + checkpointsOffset(header));
+
+  return {header.limit, bits, static_cast<size_t>(header.bitmapBytes),
+          {gaps, static_cast<size_t>(header.gapBytes), checkpoints, static_cast<size_t>(header.checkpointCount),
+           static_cast<size_t>(header.primes), header.last}};
+}
+
+bool PrimeCache::write(const std::string &fileName, const Table &table) {
+  if (table.limit < 0 || table.bytes != bitmapBytes(table.limit))
+    throw std::invalid_argument("Bitmap doesn't match limit");
+  if (table.primes.checkpointCount != checkpointCount(table.primes.size))
+    throw std::invalid_argument("Checkpoints don't match primes");
+
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.reserved = 0;
+  header.limit = table.limit;
+  header.bitmapBytes = table.bytes;
+  header.gapBytes = table.primes.gapBytes;
+  header.checkpointCount = table.primes.checkpointCount;
+  header.primes = table.primes.size;
+  header.last = table.primes.last;
+
+  const char padding[checkpointAlignment] = {};
+  const std::vector<Part> parts{{&header, sizeof(Header)},
+                                {table.bits, table.bytes},
+                                {table.primes.gaps, table.primes.gapBytes},
+                                {padding, checkpointsOffset(header) - sizeof(Header) - table.bytes - table.primes.gapBytes},
+                                {table.primes.checkpoints, table.primes.checkpointCount * sizeof(PrimeGaps::Checkpoint)}};
+
+  // Every writer has own temporary file in the same directory, it's renamed over old file
+  // only after it's written completely, so readers and other writers never see half-written file
+#ifdef _WIN32
+  const std::string temporary = fileName + "." + std::to_string(GetCurrentProcessId()) + "." +
+                                std::to_string(GetCurrentThreadId()) + ".tmp";
+  HANDLE file = CreateFileA(temporary.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return false;
+
+  const bool written = writeAll(file, parts) && FlushFileBuffers(file) != 0;
+  CloseHandle(file);
+
+  if (!written || !MoveFileExA(temporary.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+    DeleteFileA(temporary.c_str());
+    return false;
+  }
+  return true;
+#else
+  std::vector<char> temporary(fileName.begin(), fileName.end());
+  const char suffix[] = ".XXXXXX";
+  temporary.insert(temporary.end(), suffix, suffix + sizeof(suffix));
+
+  const int fd = mkstemp(temporary.data());
+  if (fd < 0)
+    return false;
+
+  // mkstemp creates file only for owner, cache is readable like other files
+  fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+
+  const bool written = writeAll(fd, parts) && fsync(fd) == 0;
+  const bool closed = close(fd) == 0;
+
+  if (!written || !closed || std::rename(temporary.data(), fileName.c_str()) != 0) {
+    unlink(temporary.data());
+    return false;
+  }
+  return true;
+#endif
+}
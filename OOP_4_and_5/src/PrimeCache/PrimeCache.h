@@ -0,0 +1,62 @@
+/**
+ * @file PrimeCache.h
+ * File with table of primes, which is kept between runs.
+ * File has versioned header, mod-30 wheel bitmap of [0, limit] (see WheelBitmap)
+ * and list of all primes up to limit with its checkpoints (see PrimeGaps) in the same form as in memory.
+ * It's mapped to memory read-only and used as is, so loading doesn't parse or copy anything.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRIMECACHE_H
+#define OOP_4_AND_5_PRIMECACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <PrimeGaps/PrimeGaps.h>
+
+class PrimeCache final {
+
+ public:
+  // Files with other version are ignored
+  static const uint32_t version = 2;
+
+  // Parts of table, which are kept in file
+  struct Table {
+    long long limit;
+    const uint8_t *bits;
+    size_t bytes;
+    PrimeGaps::View primes;
+  };
+
+  // Map file, cache is empty if file doesn't exist or is damaged
+  explicit PrimeCache(const std::string &fileName);
+  ~PrimeCache();
+  PrimeCache(const PrimeCache &) = delete;
+  PrimeCache &operator=(const PrimeCache &) = delete;
+
+  bool empty() const;
+  long long limit() const;
+
+  // Table points to mapped file, it's valid while cache lives
+  Table table() const;
+
+  // Replace file by new one. Return false, if it couldn't be written.
+  static bool write(const std::string &fileName, const Table &table);
+
+ private:
+  void unmap();
+
+  const uint8_t *data_;
+  size_t size_;
+
+#ifdef _WIN32
+  void *file_;
+  void *mapping_;
+#endif
+};
+
+#endif //OOP_4_AND_5_PRIMECACHE_H
@@ -0,0 +1,245 @@
+/**
+ * @file PrimeCounting.cpp
+ * Number of primes up to x and n-th prime without table of all primes.
+ *
+ *     pi(x) = phi(x, a) + a - 1 - P2(x, a), a = pi(x^(1/3)),
+ *     P2(x, a) = sum (pi(x / p_i) - i + 1) for a < i <= pi(sqrt(x)),
+ *
+ * phi(x, a) is number of k <= x, which aren't divisible by first a primes.
+ * Values pi(x / p_i) are less then x^(2/3), they are counted by one pass of segmented sieve.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <PrimeCounting/PrimeCounting.h>
+#include <BucketSieve/BucketSieve.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+  // phi(x, a) for a <= wheelPrimes is taken from period of primorial
+  const uint32_t wheelPrimes = 6;
+
+  // Smaller x are counted by sieve
+  const uint64_t directLimit = 1u << 16;
+
+  const uint64_t maxArgument = 1ull << 60;
+
+  // pi(n) is kept in table up to it (16 MB), larger n are found by binary search in primes
+  const uint64_t densePiLimit = 1u << 22;
+
+  uint64_t iroot(uint64_t x, uint32_t k) {
+    auto r = static_cast<uint64_t>(std::pow(static_cast<double>(x), 1.0 / k));
+
+    auto power = [k](uint64_t v) {
+      unsigned __int128 result = 1;
+      for (uint32_t i = 0; i < k; ++i)
+        result *= v;
+      return result;
+    };
+
+    while (r > 0 && power(r) > x)
+      --r;
+    while (power(r + 1) <= x)
+      ++r;
+    return r;
+  }
+
+  uint64_t count_primes(uint64_t low, uint64_t high) {
+    SegmentedSieve sieve(low, high);
+    std::vector<uint64_t> block;
+    uint64_t count = 0;
+
+    while (sieve.next(block))
+      count += block.size();
+
+    return count;
+  }
+
+  class Lehmer final {
+   public:
+    explicit Lehmer(uint64_t x);
+
+    uint64_t count();
+
+   private:
+    uint64_t phi(uint64_t x, uint32_t a) const;
+    uint64_t phiWheel(uint64_t x, uint32_t a) const;
+
+    // pi(n) for n <= sqrt(x)
+    uint32_t pi(uint64_t n) const;
+
+    uint64_t x_;
+    uint64_t root_;
+
+    // primes_[i] is i-th prime, primes_[0] = 1
+    std::vector<uint32_t> primes_;
+
+    // pi_[n] for n <= min(sqrt(x), densePiLimit)
+    std::vector<uint32_t> pi_;
+
+    // wheels_[a][r] = phi(r, a) for r < product of first a primes
+    std::vector<std::vector<uint32_t> > wheels_;
+    std::vector<uint32_t> primorials_;
+  };
+
+  Lehmer::Lehmer(uint64_t x) : x_(x), root_(iroot(x, 2)) {
+    this->primes_.emplace_back(1);
+    this->primes_.emplace_back(2);
+    for (const auto &p: SegmentedSieve::smallPrimes(this->root_ * this->root_))
+      this->primes_.emplace_back(p);
+
+    this->pi_.assign(std::min(this->root_, densePiLimit) + 1, 0);
+    for (size_t i = 1; i < this->primes_.size() && this->primes_[i] < this->pi_.size(); ++i)
+      this->pi_[this->primes_[i]] = 1;
+    for (size_t n = 1; n < this->pi_.size(); ++n)
+      this->pi_[n] += this->pi_[n - 1];
+
+    uint32_t primorial = 1;
+    for (uint32_t a = 0; a <= wheelPrimes; ++a) {
+      if (a > 0)
+        primorial *= this->primes_[a];
+
+      std::vector<uint32_t> wheel(primorial, 0);
+      for (uint32_t r = 1; r < primorial; ++r) {
+        bool coprime = true;
+        for (uint32_t i = 1; i <= a && coprime; ++i)
+          coprime = r % this->primes_[i] != 0;
+        wheel[r] = wheel[r - 1] + (coprime ? 1 : 0);
+      }
+
+      this->primorials_.emplace_back(primorial);
+      this->wheels_.emplace_back(std::move(wheel));
+    }
+  }
+
+  uint64_t Lehmer::phiWheel(uint64_t x, uint32_t a) const {
+    const uint32_t primorial = this->primorials_[a];
+    const std::vector<uint32_t> &wheel = this->wheels_[a];
+    return x / primorial * wheel[primorial - 1] + wheel[x % primorial];
+  }
+
+  uint32_t Lehmer::pi(uint64_t n) const {
+    if (n < this->pi_.size())
+      return this->pi_[n];
+
+    const auto first = this->primes_.begin() + 1;
+    return static_cast<uint32_t>(std::upper_bound(first, this->primes_.end(), n) - first);
+  }
+
+  uint64_t Lehmer::phi(uint64_t x, uint32_t a) const {
+    if (a <= wheelPrimes)
+      return this->phiWheel(x, a);
+
+    // All composites up to x are divisible by one of first a primes
+    if (x <= this->root_ && static_cast<uint64_t>(this->primes_[a + 1]) * this->primes_[a + 1] > x) {
+      const uint32_t count = this->pi(x);
+      return count > a ? count - a + 1 : 1;
+    }
+
+    uint64_t result = this->phiWheel(x, wheelPrimes);
+    for (uint32_t i = wheelPrimes + 1; i <= a; ++i) {
+      const uint64_t y = x / this->primes_[i];
+
+      // Then phi(y, i - 1) = 1 for every next prime up to x
+      if (y < this->primes_[i]) {
+        const uint64_t last = x <= this->root_ ? this->pi(x) : a;
+        if (last >= i)
+          result -= std::min<uint64_t>(last, a) - i + 1;
+        break;
+      }
+
+      result -= this->phi(y, i - 1);
+    }
+
+    return result;
+  }
+
+  uint64_t Lehmer::count() {
+    const uint32_t a = this->pi(iroot(this->x_, 3));
+    const uint32_t b = this->pi(this->root_);
+
+    uint64_t result = this->phi(this->x_, a) + a - 1;
+
+    // x / p_i grow, when i goes down, so pi of them is counted by one pass of sieve
+    const uint64_t high = b > a ? this->x_ / this->primes_[a + 1] : 0;
+    BucketSieve sieve(0, high);
+    std::vector<uint64_t> block;
+    size_t position = 0;
+    uint64_t counted = 0;
+
+    for (uint32_t i = b; i > a; --i) {
+      const uint64_t y = this->x_ / this->primes_[i];
+
+      while (true) {
+        if (position == block.size()) {
+          if (!sieve.next(block))
+            break;
+          position = 0;
+          continue;
+        }
+
+        const auto end = std::upper_bound(block.begin() + position, block.end(), y);
+        counted += static_cast<uint64_t>(end - block.begin()) - position;
+        position = static_cast<size_t>(end - block.begin());
+        if (position < block.size())
+          break;
+      }
+
+      result -= counted - i + 1;
+    }
+
+    return result;
+  }
+
+}
+
+uint64_t PrimeCounting::prime_pi(uint64_t x) {
+  if (x >= maxArgument)
+    throw std::invalid_argument("X is too large");
+
+  if (x < directLimit)
+    return x < 2 ? 0 : count_primes(0, x);
+
+  return Lehmer(x).count();
+}
+
+uint64_t PrimeCounting::nth_prime(uint64_t n) {
+  if (n == 0)
+    throw std::invalid_argument("Primes are counted from 1");
+
+  const double logN = std::log(static_cast<double>(n));
+  const double logLogN = std::log(std::max(logN, 1.0));
+
+  // Cipolla's estimation, it's close to p_n, so sieve after it is short
+  uint64_t x = n < 64 ? 0 : static_cast<uint64_t>(n * (logN + logLogN - 1 + (logLogN - 2) / logN));
+  uint64_t count = x > 0 ? prime_pi(x) : 0;
+
+  while (count >= n) {
+    x -= std::min<uint64_t>(x, static_cast<uint64_t>((count - n + 1) * 2 * std::log(static_cast<double>(x))) + 100);
+    count = x > 0 ? prime_pi(x) : 0;
+  }
+
+  // p_n is after x, gap to it is about (n - count) * log(x)
+  while (true) {
+    const double logX = std::log(static_cast<double>(std::max<uint64_t>(x, 3)));
+    const uint64_t high = x + static_cast<uint64_t>((n - count) * 2 * logX) + 1000;
+
+    SegmentedSieve sieve(x + 1, high);
+    std::vector<uint64_t> block;
+
+    while (sieve.next(block)) {
+      if (count + block.size() >= n)
+        return block[n - count - 1];
+      count += block.size();
+    }
+
+    x = high;
+  }
+}
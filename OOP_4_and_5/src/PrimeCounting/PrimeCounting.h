@@ -0,0 +1,28 @@
+/**
+ * @file PrimeCounting.h
+ * Number of primes up to x and n-th prime without table of all primes.
+ * pi(x) is computed by Meissel-Lehmer method in O(x^(2/3)) time and O(sqrt(x) / log(x)) memory
+ * (primes up to sqrt(x) and table of pi for small numbers),
+ * n-th prime is found by pi of estimation and short segmented sieve after it.
+ * @href https://en.wikipedia.org/wiki/Meissel%E2%80%93Lehmer_algorithm
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRIMECOUNTING_H
+#define OOP_4_AND_5_PRIMECOUNTING_H
+
+#include <cstdint>
+
+namespace PrimeCounting {
+
+  // Number of primes, which are not more then x (x < 2^60)
+  uint64_t prime_pi(uint64_t x);
+
+  // n-th prime, nth_prime(1) = 2
+  uint64_t nth_prime(uint64_t n);
+
+}
+
+#endif //OOP_4_AND_5_PRIMECOUNTING_H
@@ -0,0 +1,141 @@
+/**
+ * @file PrimeGaps.cpp
+ * Ascending list of primes, which stores differences between neighbours.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#include <PrimeGaps/PrimeGaps.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+const size_t PrimeGaps::checkpointStep;
+
+PrimeGaps::PrimeGaps()
+    : gapData_(nullptr), gapBytes_(0), checkpointData_(nullptr), checkpointCount_(0), mapped_(false), size_(0),
+      last_(0) {}
+
+void PrimeGaps::push_back(long long prime) {
+  if (this->mapped_)
+    this->own();
+
+  if (this->size_ > 0) {
+    const long long gap = prime - this->last_;
+    if (gap <= 0 || gap > UINT16_MAX)
+      throw std::invalid_argument("Wrong next prime");
+
+    // Zero byte marks difference, which takes two next bytes
+    if (gap < 256) {
+      this->gaps_.emplace_back(static_cast<uint8_t>(gap));
+    } else {
+      this->gaps_.emplace_back(0);
+      this->gaps_.emplace_back(static_cast<uint8_t>(gap & 0xff));
+      this->gaps_.emplace_back(static_cast<uint8_t>(gap >> 8));
+    }
+  }
+
+  if (this->size_ % checkpointStep == 0)
+    this->checkpoints_.push_back({prime, this->gaps_.size()});
+
+  this->last_ = prime;
+  ++this->size_;
+  this->sync();
+}
+
+void PrimeGaps::clear() {
+  this->gaps_.clear();
+  this->checkpoints_.clear();
+  this->mapped_ = false;
+  this->size_ = 0;
+  this->last_ = 0;
+  this->sync();
+}
+
+void PrimeGaps::own() {
+  this->gaps_.assign(this->gapData_, this->gapData_ + this->gapBytes_);
+  this->checkpoints_.assign(this->checkpointData_, this->checkpointData_ + this->checkpointCount_);
+  this->mapped_ = false;
+  this->sync();
+}
+
+void PrimeGaps::sync() {
+  this->gapData_ = this->gaps_.data();
+  this->gapBytes_ = this->gaps_.size();
+  this->checkpointData_ = this->checkpoints_.data();
+  this->checkpointCount_ = this->checkpoints_.size();
+}
+
+PrimeGaps::View PrimeGaps::view() const {
+  return {this->gapData_, this->gapBytes_, this->checkpointData_, this->checkpointCount_, this->size_, this->last_};
+}
+
+void PrimeGaps::map(const View &view) {
+  if (view.checkpointCount != (view.size + checkpointStep - 1) / checkpointStep)
+    throw std::invalid_argument("Checkpoints don't match size");
+
+  std::vector<uint8_t>().swap(this->gaps_);
+  std::vector<Checkpoint>().swap(this->checkpoints_);
+
+  this->gapData_ = view.gaps;
+  this->gapBytes_ = view.gapBytes;
+  this->checkpointData_ = view.checkpoints;
+  this->checkpointCount_ = view.checkpointCount;
+  this->mapped_ = true;
+  this->size_ = view.size;
+  this->last_ = view.last;
+}
+
+size_t PrimeGaps::size() const {
+  return this->size_;
+}
+
+size_t PrimeGaps::bytes() const {
+  return this->gapBytes_ + this->checkpointCount_ * sizeof(Checkpoint);
+}
+
+long long PrimeGaps::operator[](size_t n) const {
+  if (n >= this->size_)
+    throw std::invalid_argument("N more than size()");
+
+  return *this->iteratorAt(n);
+}
+
+size_t PrimeGaps::upperBound(long long value) const {
+  const Checkpoint *checkpoints = this->checkpointData_;
+  const auto checkpoint = std::upper_bound(checkpoints, checkpoints + this->checkpointCount_, value,
+                                           [](long long v, const Checkpoint &c) { return v < c.value; });
+  if (checkpoint == checkpoints)
+    return 0;
+
+  const auto index = static_cast<size_t>(checkpoint - checkpoints - 1);
+  auto it = this->iteratorAt(index * checkpointStep);
+  const auto last = this->end();
+
+  while (it != last && *it <= value)
+    ++it;
+
+  return it.index_;
+}
+
+PrimeGaps::const_iterator PrimeGaps::begin() const {
+  return this->iteratorAt(0);
+}
+
+PrimeGaps::const_iterator PrimeGaps::end() const {
+  return const_iterator(this, this->size_, this->gapBytes_, 0);
+}
+
+PrimeGaps::const_iterator PrimeGaps::iteratorAt(size_t n) const {
+  if (n >= this->size_)
+    return this->end();
+
+  const Checkpoint &checkpoint = this->checkpointData_[n / checkpointStep];
+  const_iterator it(this, n - n % checkpointStep, static_cast<size_t>(checkpoint.offset), checkpoint.value);
+
+  while (it.index_ < n)
+    ++it;
+
+  return it;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file PrimeGaps.h
+ * Ascending list of primes, which stores differences between neighbours.
+ * Difference takes one byte (three bytes, if it's more then 255), every 64-th prime
+ * is saved with its offset, so n-th prime and position of value are found quickly.
+ * List can be view of memory, which belongs to someone else (mapped cache file),
+ * then it's copied only when it's changed.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRIMEGAPS_H
+#define OOP_4_AND_5_PRIMEGAPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+class PrimeGaps final {
+
+ public:
+  // Every checkpointStep-th prime is saved with offset of its difference
+  static const size_t checkpointStep = 64;
+
+  struct Checkpoint {
+    int64_t value;
+    uint64_t offset;
+  };
+
+  // Whole list as it's kept in memory
+  struct View {
+    const uint8_t *gaps;
+    size_t gapBytes;
+    const Checkpoint *checkpoints;
+    size_t checkpointCount;
+    size_t size;
+    long long last;
+  };
+
+  class const_iterator final {
+   public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef long long value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const long long *pointer;
+    typedef const long long &reference;
+
+    const_iterator() : owner_(nullptr), index_(0), offset_(0), value_(0) {}
+
+    reference operator*() const { return this->value_; }
+
+    const_iterator &operator++() {
+      if (++this->index_ < this->owner_->size_)
+        this->value_ += this->owner_->decode(this->offset_);
+      return *this;
+    }
+
+    const_iterator operator++(int) {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator &other) const { return this->index_ == other.index_; }
+    bool operator!=(const const_iterator &other) const { return this->index_ != other.index_; }
+
+   private:
+    friend class PrimeGaps;
+
+    const_iterator(const PrimeGaps *owner, size_t index, size_t offset, long long value)
+        : owner_(owner), index_(index), offset_(offset), value_(value) {}
+
+    const PrimeGaps *owner_;
+    size_t index_;
+
+    // Position of difference between current and next prime
+    size_t offset_;
+    long long value_;
+  };
+
+  PrimeGaps();
+  PrimeGaps(const PrimeGaps &) = delete;
+  PrimeGaps &operator=(const PrimeGaps &) = delete;
+
+  // prime must be more then all primes in list
+  void push_back(long long prime);
+  void clear();
+
+  size_t size() const;
+  long long operator[](size_t n) const;
+
+  // Memory, which is taken by differences and checkpoints
+  size_t bytes() const;
+
+  // Number of primes, which are not more then value
+  size_t upperBound(long long value) const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // Iterator to n-th prime
+  const_iterator iteratorAt(size_t n) const;
+
+  View view() const;
+
+  // Use list from memory, which must live until list is changed or destroyed. Nothing is copied.
+  void map(const View &view);
+
+ private:
+  inline long long decode(size_t &offset) const {
+    const uint8_t gap = this->gapData_[offset];
+    if (gap != 0) {
+      ++offset;
+      return gap;
+    }
+
+    const long long wide = this->gapData_[offset + 1] | (static_cast<long long>(this->gapData_[offset + 2]) << 8);
+    offset += 3;
+    return wide;
+  }
+
+  // Copy mapped list to own vectors before change
+  void own();
+
+  // Point reading to own vectors
+  void sync();
+
+  std::vector<uint8_t> gaps_;
+  std::vector<Checkpoint> checkpoints_;
+
+  // All reading goes through these pointers, they point to own vectors or mapped memory
+  const uint8_t *gapData_;
+  size_t gapBytes_;
+  const Checkpoint *checkpointData_;
+  size_t checkpointCount_;
+  bool mapped_;
+
+  size_t size_;
+  long long last_;
+};
+
+#endif //OOP_4_AND_5_PRIMEGAPS_H
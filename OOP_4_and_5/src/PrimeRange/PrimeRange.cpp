@@ -0,0 +1,46 @@
+/**
+ * @file PrimeRange.cpp
+ * Lazy sequence of primes from window [low, high].
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <PrimeRange/PrimeRange.h>
+
+#include <stdexcept>
+
+PrimeRange::const_iterator::const_iterator(uint64_t low, uint64_t high)
+    : state_(std::make_shared<State>(low, high)) {
+  this->fill();
+}
+
+void PrimeRange::const_iterator::fill() {
+  while (this->state_->position >= this->state_->block.size()) {
+    this->state_->position = 0;
+    if (!this->state_->sieve.next(this->state_->block))
+      return;
+  }
+}
+
+PrimeRange::const_iterator &PrimeRange::const_iterator::operator++() {
+  ++this->state_->position;
+  this->fill();
+  return *this;
+}
+
+PrimeRange::PrimeRange(uint64_t low, uint64_t high) : low_(low), high_(high) {
+  if (high >= (1ull << 62))
+    throw std::invalid_argument("High bound is too large");
+}
+
+PrimeRange::const_iterator PrimeRange::begin() const {
+  if (this->low_ > this->high_)
+    return this->end();
+
+  return const_iterator(this->low_, this->high_);
+}
+
+PrimeRange::const_iterator PrimeRange::end() const {
+  return const_iterator();
+}
@@ -0,0 +1,77 @@
+/**
+ * @file PrimeRange.h
+ * Lazy sequence of primes from window [low, high].
+ * Only window is sieved, block by block, with primes up to sqrt(high) (see BucketSieve),
+ * so primes of high windows can be walked without storing them:
+ *
+ *     for (const auto &p: PrimeRange(1000000000000000ull, 1000000001000000ull)) { ... }
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRIMERANGE_H
+#define OOP_4_AND_5_PRIMERANGE_H
+
+#include <BucketSieve/BucketSieve.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+class PrimeRange final {
+
+ public:
+  // Single pass iterator, its copies share position
+  class const_iterator final {
+   public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef uint64_t value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const uint64_t *pointer;
+    typedef const uint64_t &reference;
+
+    const_iterator() = default;
+
+    reference operator*() const { return this->state_->block[this->state_->position]; }
+
+    const_iterator &operator++();
+
+    bool operator==(const const_iterator &other) const { return this->atEnd() == other.atEnd(); }
+    bool operator!=(const const_iterator &other) const { return this->atEnd() != other.atEnd(); }
+
+   private:
+    friend class PrimeRange;
+
+    struct State {
+      State(uint64_t low, uint64_t high) : sieve(low, high), position(0) {}
+
+      BucketSieve sieve;
+      std::vector<uint64_t> block;
+      size_t position;
+    };
+
+    const_iterator(uint64_t low, uint64_t high);
+
+    // Take next blocks, until non-empty one is found
+    void fill();
+
+    bool atEnd() const { return !this->state_ || this->state_->position >= this->state_->block.size(); }
+
+    std::shared_ptr<State> state_;
+  };
+
+  PrimeRange(uint64_t low, uint64_t high);
+
+  // Every call starts new pass of sieve
+  const_iterator begin() const;
+  const_iterator end() const;
+
+ private:
+  uint64_t low_;
+  uint64_t high_;
+};
+
+#endif //OOP_4_AND_5_PRIMERANGE_H
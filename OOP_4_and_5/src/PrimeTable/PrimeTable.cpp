@@ -0,0 +1,70 @@
+/**
+ * @file PrimeTable.cpp
+ * Process-wide table of primes below 2^32.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#include <PrimeTable/PrimeTable.h>
+
+#include <algorithm>
+
+namespace {
+
+  // Limit of first snapshot, next snapshots are at least twice larger,
+  // so all snapshots together take less then twice memory of last one
+  const uint32_t minLimit = 1u << 16;
+
+}
+
+std::vector<uint32_t>::const_iterator PrimeTable::Snapshot::upTo(uint32_t bound) const {
+  return std::upper_bound(this->primes_.begin(), this->primes_.end(), bound);
+}
+
+PrimeTable &PrimeTable::instance() {
+  static PrimeTable table;
+  return table;
+}
+
+const PrimeTable::Snapshot &PrimeTable::get(uint32_t limit) {
+  const Snapshot *snapshot = this->current_.load(std::memory_order_acquire);
+  if (snapshot != nullptr && snapshot->limit() >= limit)
+    return *snapshot;
+
+  std::lock_guard<std::mutex> lg(this->growMutex_);
+
+  // Other thread could grow table while this one waited
+  snapshot = this->current_.load(std::memory_order_acquire);
+  if (snapshot != nullptr && snapshot->limit() >= limit)
+    return *snapshot;
+
+  const uint64_t doubled = snapshot != nullptr ? 2ull * snapshot->limit() : minLimit;
+  const auto newLimit = static_cast<uint32_t>(std::min<uint64_t>(UINT32_MAX, std::max<uint64_t>(limit, doubled)));
+
+  if (!this->cacheLoaded_ && !this->cacheFile_.empty()) {
+    this->cacheLoaded_ = true;
+    if (this->sieve_.loadCache(this->cacheFile_))
+      this->cacheLimit_ = this->sieve_.limit();
+  }
+
+  this->sieve_.setPrimes(newLimit);
+  std::vector<uint32_t> primes(this->sieve_.compactBegin(), this->sieve_.compactEnd());
+
+  // Cache is written only when it grows, failure to write isn't error
+  if (!this->cacheFile_.empty() && this->sieve_.limit() > this->cacheLimit_) {
+    if (this->sieve_.saveCache(this->cacheFile_))
+      this->cacheLimit_ = this->sieve_.limit();
+  }
+
+  this->snapshots_.emplace_back(new Snapshot(std::move(primes), newLimit));
+  this->current_.store(this->snapshots_.back().get(), std::memory_order_release);
+
+  return *this->snapshots_.back();
+}
+
+void PrimeTable::setCacheFile(const std::string &fileName) {
+  std::lock_guard<std::mutex> lg(this->growMutex_);
+  this->cacheFile_ = fileName;
+  this->cacheLoaded_ = false;
+}
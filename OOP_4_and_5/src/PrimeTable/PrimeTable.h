@@ -0,0 +1,77 @@
+/**
+ * @file PrimeTable.h
+ * Process-wide table of primes below 2^32.
+ * Table only grows: every growth publishes new immutable snapshot by atomic pointer,
+ * old snapshots stay alive, so readers never lock and may keep references.
+ * Table can be loaded from cache file and saved back after growth.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRIMETABLE_H
+#define OOP_4_AND_5_PRIMETABLE_H
+
+#include <AtkinSieve/AtkinSieve.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class PrimeTable final {
+
+ public:
+  // All primes, which are not more then limit()
+  class Snapshot final {
+   public:
+    Snapshot(std::vector<uint32_t> &&primes, uint32_t limit) : primes_(std::move(primes)), limit_(limit) {}
+    Snapshot(const Snapshot &) = delete;
+    Snapshot &operator=(const Snapshot &) = delete;
+
+    uint32_t limit() const { return this->limit_; }
+    size_t size() const { return this->primes_.size(); }
+
+    std::vector<uint32_t>::const_iterator begin() const { return this->primes_.begin(); }
+    std::vector<uint32_t>::const_iterator end() const { return this->primes_.end(); }
+
+    // End of primes, which are not more then bound
+    std::vector<uint32_t>::const_iterator upTo(uint32_t bound) const;
+
+   private:
+    const std::vector<uint32_t> primes_;
+    const uint32_t limit_;
+  };
+
+  static PrimeTable &instance();
+
+  PrimeTable(const PrimeTable &) = delete;
+  PrimeTable &operator=(const PrimeTable &) = delete;
+
+  // Snapshot, which has all primes up to limit
+  const Snapshot &get(uint32_t limit);
+
+  // Empty name turns cache off (default)
+  void setCacheFile(const std::string &fileName);
+
+ private:
+  // Primes are copied to snapshots, so sieve keeps only compact gap list
+  PrimeTable() : current_(nullptr), sieve_(0, AtkinSieve::Storage::Gaps), cacheLoaded_(false), cacheLimit_(0) {}
+
+  std::atomic<const Snapshot *> current_;
+
+  // Only writers take it
+  std::mutex growMutex_;
+  AtkinSieve sieve_;
+  std::vector<std::unique_ptr<const Snapshot> > snapshots_;
+
+  std::string cacheFile_;
+  bool cacheLoaded_;
+
+  // Limit of primes, which are in cache file
+  long long cacheLimit_;
+};
+
+#endif //OOP_4_AND_5_PRIMETABLE_H
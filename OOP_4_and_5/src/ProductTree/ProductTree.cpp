@@ -0,0 +1,64 @@
+/**
+ * @file ProductTree.cpp
+ * Product tree of primes for trial division of large numbers.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <ProductTree/ProductTree.h>
+
+#include <stdexcept>
+
+ProductTree::ProductTree(const std::vector<uint32_t> &primes) : primes_(primes) {
+  if (primes.empty())
+    throw std::invalid_argument("Tree needs primes");
+
+  std::vector<mpz_class> leaves;
+  leaves.reserve(primes.size());
+  for (const auto &p: primes)
+    leaves.emplace_back(p);
+
+  this->levels_.push_back(std::move(leaves));
+
+  while (this->levels_.back().size() > 1) {
+    const auto &lower = this->levels_.back();
+    std::vector<mpz_class> upper((lower.size() + 1) / 2);
+
+    for (size_t i = 0; i + 1 < lower.size(); i += 2)
+      mpz_mul(upper[i / 2].get_mpz_t(), lower[i].get_mpz_t(), lower[i + 1].get_mpz_t());
+    if (lower.size() % 2 == 1)
+      upper.back() = lower.back();
+
+    this->levels_.push_back(std::move(upper));
+  }
+}
+
+/**
+ * g is gcd of x with product of node. Left child has smaller primes,
+ * so the first child with gcd more then 1 has the smallest divisor.
+ */
+uint32_t ProductTree::smallestDivisor(uint32_t level, uint32_t index, const mpz_class &g) const {
+  if (level == 0)
+    return this->primes_[index];
+
+  const auto &children = this->levels_[level - 1];
+  mpz_class childGcd;
+
+  for (uint32_t child = 2 * index; child <= 2 * index + 1 && child < children.size(); ++child) {
+    mpz_gcd(childGcd.get_mpz_t(), g.get_mpz_t(), children[child].get_mpz_t());
+    if (childGcd != 1)
+      return this->smallestDivisor(level - 1, child, childGcd);
+  }
+
+  return 0;
+}
+
+uint32_t ProductTree::smallestDivisor(const mpz_class &x) const {
+  mpz_class g;
+  mpz_gcd(g.get_mpz_t(), x.get_mpz_t(), this->levels_.back()[0].get_mpz_t());
+  if (g == 1)
+    return 0;
+
+  return this->smallestDivisor(static_cast<uint32_t>(this->levels_.size() - 1), 0, g);
+}
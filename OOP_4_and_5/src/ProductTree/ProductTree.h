@@ -0,0 +1,37 @@
+/**
+ * @file ProductTree.h
+ * Product tree of primes for trial division of large numbers.
+ * Every node keeps product of primes of its subtree, so divisor of number is found
+ * by gcd with root and splitting gcd down the tree, only subtrees with common divisor are visited.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_PRODUCTTREE_H
+#define OOP_4_AND_5_PRODUCTTREE_H
+
+#include <cstdint>
+#include <vector>
+#include <gmpxx.h>
+
+class ProductTree final {
+
+ public:
+  explicit ProductTree(const std::vector<uint32_t> &primes);
+  ProductTree(const ProductTree &) = delete;
+  ProductTree &operator=(const ProductTree &) = delete;
+
+  // The smallest prime, which divides x, or 0
+  uint32_t smallestDivisor(const mpz_class &x) const;
+
+ private:
+  uint32_t smallestDivisor(uint32_t level, uint32_t index, const mpz_class &g) const;
+
+  std::vector<uint32_t> primes_;
+
+  // levels_[0] are primes, levels_[k][i] = levels_[k - 1][2i] * levels_[k - 1][2i + 1]
+  std::vector<std::vector<mpz_class> > levels_;
+};
+
+#endif //OOP_4_AND_5_PRODUCTTREE_H
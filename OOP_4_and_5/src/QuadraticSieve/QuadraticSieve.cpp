@@ -12,291 +12,558 @@
  */
 #include <QuadraticSieve/QuadraticSieve.h>
 #include <MathFunctions/MathFunctions.h>
+#include <SelfInitializingSieve/SelfInitializingSieve.h>
+#include <SieveScanner/SieveScanner.h>
+#include <RelationCollector/RelationCollector.h>
 
+#include <algorithm>
+#include <exception>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include <cmath>
 #include <map>
 #include <Matrix/Matrix.h>
+#include <SparseMatrix/SparseMatrix.h>
+#include <BlockLanczos/BlockLanczos.h>
+#include <RelationFilter/RelationFilter.h>
 
+namespace {
 
-QuadraticSieve::QuadraticSieve() {
-  this->atkinSieve_.setPrimes(35000);
+  // Matrix for factor base with more primes is solved as sparse
+  const size_t sparseMinFactorBase = 1000;
 
-  for (const auto &i: this->atkinSieve_) {
-    firstPrimes.emplace_back(i);
-  }
-}
+  // Cliques are removed, while matrix has more then filterExcess extra columns
+  const uint32_t filterExcess = 128;
+
+  // Relations more then size of factor base, every one gives dependency to try (up to 64)
+  const size_t extraRelations = 64;
+
+  // If all dependencies are trivial, sieving continues for retryRelations new relations
+  const size_t retryRelations = 32;
+  const uint32_t maxRetries = 5;
+
+  // Classic sieve stops after so many intervals: Q(x) grows with x, and smooth numbers become too rare.
+  // Good parameters need a few intervals, too small factor base could sieve until overflow of x.
+  const uint32_t maxSieveIntervals = 256;
+
+  // If sieve fails after all retries, it starts again with larger factor base
+  const uint32_t retryFactorBaseScale = 2;
+
+  // Primes up to it are checked by trial division before sieving
+  const uint32_t firstPrimesLimit = 35000;
+
+  // Multiplier is chosen by quadratic residues modulo primes up to it
+  const uint32_t multiplierPrimesLimit = 1000;
 
-void QuadraticSieve::createFactorBase(const mpz_class &n,
-                                      std::vector<uint32_t> &factorBase,
-                                      uint32_t startFactorBaseSize) {
-  const double logN = mpz_sizeinbase(n.get_mpz_t(), 2) * std::log(2);
-  const double loglogN = std::log(logN);
+  // Sieve threads of collectRelations, they are stopped and joined on every exit, exception too
+  class SieveWorkers final {
+   public:
+    explicit SieveWorkers(RelationCollector &collector) : collector_(collector) {}
+    SieveWorkers(const SieveWorkers &) = delete;
+    SieveWorkers &operator=(const SieveWorkers &) = delete;
+
+    ~SieveWorkers() {
+      this->join();
+    }
+
+    // Sieve polynomials until collector is stopped. Exception stops collector, it's thrown again by rethrow().
+    void start(SelfInitializingSieve &sieve) {
+      this->threads_.emplace_back([this, &sieve]() {
+        try {
+          while (!this->collector_.stopped()) {
+            RelationCollector::Batch batch;
+            sieve.sievePolynomial(batch.relations, batch.partials);
+            this->collector_.push(std::move(batch));
+          }
+        } catch (...) {
+          std::lock_guard<std::mutex> lg(this->errorMutex_);
+          if (!this->error_)
+            this->error_ = std::current_exception();
+          this->collector_.stop();
+        }
+      });
+    }
+
+    void join() {
+      this->collector_.stop();
+      for (auto &thread: this->threads_)
+        thread.join();
+      this->threads_.clear();
+    }
+
+    void rethrow() {
+      std::lock_guard<std::mutex> lg(this->errorMutex_);
+      if (this->error_)
+        std::rethrow_exception(this->error_);
+    }
 
-  const uint32_t base = startFactorBaseSize +
-                        static_cast<uint32_t>(std::ceil(std::exp(0.55 * std::sqrt(logN * loglogN))));
+   private:
+    RelationCollector &collector_;
+    std::vector<std::thread> threads_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+  };
 
-  std::unique_lock<std::mutex> lg(this->m_);
-  atkinSieve_.setPrimes(base);
-  lg.unlock();
-  this->filterFactorBase(n, factorBase);
 }
 
-void QuadraticSieve::filterFactorBase(const mpz_class &n, std::vector<uint32_t> &factorBase) {
-  std::unique_lock<std::mutex> lg(this->m_);
-  std::vector<uint32_t> temp(atkinSieve_.begin(), atkinSieve_.end());
-  lg.unlock();
+QuadraticSieve::QuadraticSieve()
+    : firstPrimes(PrimeTable::instance().get(firstPrimesLimit)),
+      firstPrimesTree_(std::vector<uint32_t>(firstPrimes.begin(), firstPrimes.upTo(firstPrimesLimit))) {}
+
+void QuadraticSieve::createFactorBaseBySize(const mpz_class &n,
+                                            std::vector<uint32_t> &factorBase,
+                                            uint32_t factorBaseSize) {
+  // Only half of primes are quadratic residues modulo N.
+  // Primes of multiplier k divide kN, they are taken too: Q(x) has such prime once or never.
+  auto bound = static_cast<uint32_t>(2.5 * factorBaseSize * std::log(factorBaseSize + 2) + 100);
+
+  while (true) {
+    const auto &primes = PrimeTable::instance().get(bound);
+    const auto end = primes.upTo(bound);
+
+    factorBase.clear();
+    for (auto it = primes.begin(); it != end; ++it) {
+      const uint32_t p = *it;
+      if (MathFunctions::simple_legendre(mpz_fdiv_ui(n.get_mpz_t(), p), p) != -1) {
+        factorBase.emplace_back(p);
+      }
 
-  for (const auto &i: temp) {
-    if (mpz_legendre(n.get_mpz_t(), mpz_class(i).get_mpz_t()) == 1) {
-      factorBase.emplace_back(i);
+      if (factorBase.size() == factorBaseSize)
+        return;
     }
+
+    bound *= 2;
   }
 }
 
-void QuadraticSieve::aproxFactorBase(const std::vector<uint32_t> &factorBase, std::vector<double> &logFactorBase) {
+void QuadraticSieve::aproxFactorBase(const std::vector<uint32_t> &factorBase, std::vector<uint8_t> &logFactorBase) {
   logFactorBase.clear();
 
   for (const auto &i: factorBase) {
-    logFactorBase.emplace_back(std::log2(i));
+    logFactorBase.emplace_back(SieveScanner::scaled_log(i));
   }
 }
 
 void QuadraticSieve::solveShanksEquation(const mpz_class &n, const mpz_class &sqrtN,
                                          const std::vector<uint32_t> &factorBase,
                                          std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots) {
-  mpz_class tempPrimeNumber = 0;
-  mpz_class numModPrimeNumber = 0;
-  mpz_class firstRootEquation = 0;
-  mpz_class secondRootEquation = 0;
-
-  for (auto &primeNumber : factorBase) {
-    tempPrimeNumber = primeNumber;
-
-    mpz_mod(numModPrimeNumber.get_mpz_t(), n.get_mpz_t(), tempPrimeNumber.get_mpz_t());
+  std::vector<uint32_t> roots;
+  MathFunctions::sqrt_mod(n, factorBase, roots);
 
-    const auto solveEquation = MathFunctions::Shanks_Tonelli(numModPrimeNumber.get_ui(), primeNumber);
-
-    mpz_ui_sub(firstRootEquation.get_mpz_t(), solveEquation.first, sqrtN.get_mpz_t());
-    mpz_ui_sub(secondRootEquation.get_mpz_t(), solveEquation.second, sqrtN.get_mpz_t());
+  // Roots of (x + sqrtN)^2 = N (mod p), they are equal for p = 2 and for p, which divides N
+  for (uint32_t i = 0; i < factorBase.size(); ++i) {
+    const uint32_t p = factorBase[i];
+    const auto sqrtNModP = static_cast<uint32_t>(mpz_fdiv_ui(sqrtN.get_mpz_t(), p));
 
-    shanksRoots.emplace_back(MathFunctions::mod(firstRootEquation, tempPrimeNumber),
-                             MathFunctions::mod(secondRootEquation, tempPrimeNumber));
+    shanksRoots.emplace_back((roots[i] + p - sqrtNModP) % p,
+                             (2 * p - roots[i] - sqrtNModP) % p);
   }
 }
 
+/**
+ * Q(x) is about 2 * x * sqrt(N), so log|Q| grows by one bit, when x is doubled.
+ * Interval is split into parts [x, 2x), every part starts from value, which is got from |Q| at its start:
+ * number is candidate, if logs of its primes are not less then log|Q| - threshold.
+ * Only the first intervals have several parts, they have the smallest Q.
+ */
 void QuadraticSieve::generateAproxForInterval(const mpz_class &n, const mpz_class &sqrtN,
-                                              const uint32_t &startInterval, const uint32_t &interval,
-                                              std::vector<double> &approx,
-                                              double &prevLogEstimate,
-                                              uint32_t &nextLogEstimate) {
-
-  uint32_t x = startInterval + 1;
-  for (uint32_t i = 1; i < interval; ++i) {
-    if (nextLogEstimate <= x) {
-      const mpz_class temp = solveFactorBaseEquation(n, sqrtN, x);
-      prevLogEstimate = mpz_sizeinbase(temp.get_mpz_t(), 2);
-      nextLogEstimate = nextLogEstimate * 1.8 + 1;
-    }
-    approx[i] = prevLogEstimate;
-    x++;
+                                              const uint32_t &startInterval,
+                                              const uint32_t &endInterval,
+                                              const double &threshold,
+                                              std::vector<uint8_t> &sieve) {
+  for (uint32_t x = startInterval; x < endInterval;) {
+    const uint32_t next = static_cast<uint32_t>(std::min<uint64_t>(endInterval, std::max<uint64_t>(x + 1, 2ull * x)));
+
+    const mpz_class Q = solveFactorBaseEquation(n, sqrtN, x);
+    const double logEstimate = mpz_sizeinbase(Q.get_mpz_t(), 2);
+
+    std::fill(sieve.begin() + (x - startInterval), sieve.begin() + (next - startInterval),
+              SieveScanner::initial_value(logEstimate - threshold));
+    x = next;
   }
 }
 
 void QuadraticSieve::sieveNumbersForInterval(const uint32_t &startInterval,
                                              const uint32_t &endInterval,
                                              const std::vector<uint32_t> &factorBase,
-                                             const std::vector<double> &logFactorBase,
-                                             std::vector<double> &approx,
+                                             const std::vector<uint8_t> &logFactorBase,
+                                             std::vector<uint8_t> &sieve,
                                              std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots) {
   for (uint32_t i = 0; i < factorBase.size(); ++i) {
     const auto &p = factorBase[i];
     const auto &logp = logFactorBase[i];
+    const bool twoRoots = shanksRoots[i].first != shanksRoots[i].second;
 
     while (shanksRoots[i].first < endInterval) {
-      approx[shanksRoots[i].first - startInterval] -= logp;
+      sieve[shanksRoots[i].first - startInterval] += logp;
       shanksRoots[i].first += p;
     }
 
-    if (p == 2)
+    if (!twoRoots) {
+      shanksRoots[i].second = shanksRoots[i].first;
       continue;
+    }
 
     while (shanksRoots[i].second < endInterval) {
-      approx[shanksRoots[i].second - startInterval] -= logp;
+      sieve[shanksRoots[i].second - startInterval] += logp;
       shanksRoots[i].second += p;
     }
   }
 }
 
-mpz_class QuadraticSieve::factorSmallNumber(const std::vector<uint32_t> &factorBase,
-                                            std::vector<uint32_t> &factors,
-                                            mpz_class number) {
-  factors.clear();
+/**
+ * Find primes of factor base, which divide Q(x) of every candidate.
+ * Roots are already moved past the interval by sieving, so first hit is (root - startInterval) mod p.
+ * Small primes are checked for every candidate, large ones walk over interval again
+ * and stop only on candidates: it is cheaper then check of every candidate.
+ */
+void QuadraticSieve::resieveCandidates(const uint32_t &startInterval,
+                                       const std::vector<uint32_t> &factorBase,
+                                       const std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
+                                       const std::vector<uint8_t> &sieve,
+                                       const std::vector<uint32_t> &positions,
+                                       std::vector<std::vector<uint32_t> > &hits) {
+  const auto interval = static_cast<uint32_t>(sieve.size());
+  hits.assign(positions.size(), std::vector<uint32_t>());
+
+  for (uint32_t k = 0; k < factorBase.size(); ++k) {
+    const uint32_t p = factorBase[k];
+    const uint32_t first = (shanksRoots[k].first - startInterval) % p;
+    const uint32_t second = (shanksRoots[k].second - startInterval) % p;
+
+    if (static_cast<uint64_t>(p) * positions.size() <= interval) {
+      for (uint32_t c = 0; c < positions.size(); ++c) {
+        const uint32_t r = positions[c] % p;
+        if (r == first || r == second)
+          hits[c].emplace_back(k);
+      }
+      continue;
+    }
+
+    for (const uint32_t root: {first, second}) {
+      for (uint32_t i = root; i < interval; i += p) {
+        if ((sieve[i] & SieveScanner::candidateMark) == 0)
+          continue;
+
+        const auto c = std::lower_bound(positions.begin(), positions.end(), i) - positions.begin();
+        hits[c].emplace_back(k);
+      }
 
-  for (uint32_t j = 0; j < factorBase.size(); ++j) {
-    const uint32_t &p = factorBase[j];
-    while (mpz_divisible_ui_p(number.get_mpz_t(), p)) {
-      mpz_divexact_ui(number.get_mpz_t(), number.get_mpz_t(), p);
-      factors.emplace_back(j); // The j:th factor base number was a factorNumber.
+      if (first == second)
+        break;
     }
   }
-
-  return number;
 }
 
 void QuadraticSieve::getNumbersBelowThreshold(const mpz_class &n,
                                               const mpz_class &sqrtN,
                                               const uint32_t &startInterval,
-                                              const uint32_t &interval,
-                                              const double &threshold,
                                               const std::vector<uint32_t> &factorBase,
-                                              const std::vector<double> &approx,
-                                              std::vector<uint32_t> &smoothNumbers,
-                                              std::vector<std::vector<uint32_t> > &factSmoothNumbers) {
+                                              const std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
+                                              const std::vector<uint8_t> &sieve,
+                                              const uint64_t &largePrimeBound,
+                                              size_t count,
+                                              PartialRelations &partials,
+                                              std::vector<Relation> &relations) {
+
+  std::vector<uint32_t> positions;
+  SieveScanner::find_candidates(sieve, positions);
+
+  std::vector<std::vector<uint32_t> > hits;
+  this->resieveCandidates(startInterval, factorBase, shanksRoots, sieve, positions, hits);
 
   std::vector<uint32_t> factors;
-  uint32_t x = startInterval;
 
-  for (uint32_t i = 0; i < interval; ++i) {
-    if (std::abs(approx[i]) >= threshold) {
-      ++x;
-      continue;
-    }
+  for (uint32_t c = 0; c < positions.size() && relations.size() < count; ++c) {
+    mpz_class y;
+    mpz_add_ui(y.get_mpz_t(), sqrtN.get_mpz_t(), startInterval + positions[c]);
 
-    mpz_class Q = solveFactorBaseEquation(n, sqrtN, x);
-    Q = this->factorSmallNumber(factorBase, factors, Q);
+    mpz_class Q = y * y - n;
+
+    // Q is negative for x = 0, because sqrtN is rounded down
+    const bool negative = Q < 0;
+    mpz_abs(Q.get_mpz_t(), Q.get_mpz_t());
+
+    // Only primes, which were found by resieving, are divided out
+    factors.clear();
+    for (const auto &k: hits[c]) {
+      while (mpz_divisible_ui_p(Q.get_mpz_t(), factorBase[k])) {
+        mpz_divexact_ui(Q.get_mpz_t(), Q.get_mpz_t(), factorBase[k]);
+        factors.emplace_back(k);
+      }
+    }
 
     if (Q == 1) {
-      factSmoothNumbers.emplace_back(factors);
-      smoothNumbers.emplace_back(x);
-      break;
+      relations.push_back(Relation{y, factors, negative});
+    } else if (mpz_cmp_ui(Q.get_mpz_t(), largePrimeBound) < 0) {
+      partials.addRelation(Relation{y, factors, negative}, Q.get_ui(), 1, relations);
     }
+  }
+}
 
-    if (smoothNumbers.size() >= factorBase.size() + 5)
-      break;
+bool QuadraticSieve::getSmoothNumbers(SieveContext &context, size_t count) {
+  const auto &parameters = context.parameters;
+  const uint32_t INTERVAL = 2 * parameters.halfInterval;
+  const double threshold = parameters.thresholdFactor * std::log2(context.factorBase.back());
+
+  // Cofactor less then it is large prime, because it is less then (max prime)^2.
+  // Bound fits in unsigned long of GMP calls on every platform, it is 32-bit on Windows.
+  const uint64_t maxPrime = context.factorBase.back();
+  const uint64_t largePrimeBound = std::min({maxPrime * parameters.largePrimeMultiplier, maxPrime * maxPrime,
+                                             static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())});
+
+  std::vector<uint8_t> sieve(INTERVAL);
 
-    ++x;
+  // Position of interval is uint32_t, so it must not overflow too
+  const uint64_t sieveLimit = std::min<uint64_t>(static_cast<uint64_t>(maxSieveIntervals) * INTERVAL,
+                                                 std::numeric_limits<uint32_t>::max() - INTERVAL);
+
+  // Sieving continues from the place, where previous call has stopped
+  while (context.relations.size() < count) {
+    if (context.startInterval >= sieveLimit)
+      return false;
+
+    const uint32_t startInterval = context.startInterval;
+    const uint32_t endInterval = startInterval + INTERVAL;
+
+    this->generateAproxForInterval(context.n, context.sqrtN, startInterval, endInterval, threshold, sieve);
+
+    this->sieveNumbersForInterval(startInterval, endInterval, context.factorBase, context.logFactorBase,
+                                  sieve, context.shanksRoots);
+
+    this->getNumbersBelowThreshold(context.n, context.sqrtN, startInterval,
+                                   context.factorBase, context.shanksRoots, sieve, largePrimeBound, count,
+                                   context.partials, context.relations);
+
+    context.startInterval = endInterval;
   }
-}
 
-void QuadraticSieve::getSmoothNumbers(const mpz_class &n, const mpz_class &sqrtN,
-                                      const std::vector<uint32_t> &factorBase,
-                                      std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
-                                      std::vector<uint32_t> &smoothNumbers,
-                                      std::vector<std::vector<uint32_t> > &factSmoothNumbers) {
-  std::vector<double> logFactorBase;
-  std::vector<double> approx;
+  return true;
+}
 
-  double prevLogEstimate = 0;
-  uint32_t nextLogEstimate = 1;
+/**
+ * Get a and b, so a^2 = b^2 (mod N), for relations which are chosen by x.
+ */
+void QuadraticSieve::findSquareRoots(const mpz_class &n,
+                                     const std::vector<uint32_t> &factorBase,
+                                     const std::vector<Relation> &relations,
+                                     const std::vector<uint32_t> &x,
+                                     mpz_class &a, mpz_class &b) {
+  mpz_class num;
 
-  uint32_t INTERVAL = factorBase.size() * 4;
+  a = 1;
+  b = 1;
 
-  uint32_t startInterval = 0;
-  uint32_t endInterval = INTERVAL;
+  std::vector<uint32_t> decomp(factorBase.size(), 0);
+  for (uint32_t i = 0; i < relations.size(); ++i) {
+    if (x[i] == 1) {
+      for (const auto &p: relations[i].factors)
+        ++decomp[p];
 
-  approx.assign(INTERVAL, 0);
+      mpz_mul(b.get_mpz_t(), b.get_mpz_t(), relations[i].y.get_mpz_t());
+      mpz_mod(b.get_mpz_t(), b.get_mpz_t(), n.get_mpz_t());
 
-  this->aproxFactorBase(factorBase, logFactorBase);
+      // Large primes of combined relations are already in square root
+      mpz_mul(a.get_mpz_t(), a.get_mpz_t(), relations[i].largeFactor.get_mpz_t());
+      mpz_mod(a.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t());
+    }
+  }
 
-  while (smoothNumbers.size() < factorBase.size() + 5) {
+  for (uint32_t p = 0; p < factorBase.size(); ++p) {
+    mpz_powm_ui(num.get_mpz_t(), mpz_class(factorBase[p]).get_mpz_t(), decomp[p] / 2, n.get_mpz_t());
+    mpz_mul(a.get_mpz_t(), a.get_mpz_t(), num.get_mpz_t());
+    mpz_mod(a.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t());
+  }
+}
 
-    this->generateAproxForInterval(n, sqrtN, startInterval, INTERVAL, approx, prevLogEstimate, nextLogEstimate);
+mpz_class QuadraticSieve::tryDependencies(const mpz_class &n,
+                                          const std::vector<uint32_t> &factorBase,
+                                          const std::vector<Relation> &relations,
+                                          const RelationFilter &filter,
+                                          const std::vector<uint64_t> &dependencies) {
+  mpz_class a;
+  mpz_class b;
+  mpz_class factor;
+  std::vector<uint32_t> x(relations.size(), 0);
+
+  // Every bit of dependencies is one solution of Ax = 0
+  for (uint32_t k = 0; k < 64; ++k) {
+    bool empty = true;
+    for (uint32_t j = 0; j < filter.cols(); ++j) {
+      x[filter.relationIndex(j)] = static_cast<uint32_t>((dependencies[j] >> k) & 1);
+      empty = empty && x[filter.relationIndex(j)] == 0;
+    }
 
-    this->sieveNumbersForInterval(startInterval, endInterval, factorBase, logFactorBase, approx, shanksRoots);
+    if (empty)
+      continue;
 
-    const double threshold = std::log2(factorBase.back());
+    this->findSquareRoots(n, factorBase, relations, x, a, b);
 
-    this->getNumbersBelowThreshold(n, sqrtN, startInterval, INTERVAL, threshold,
-                                   factorBase, approx, smoothNumbers, factSmoothNumbers);
+    mpz_sub(factor.get_mpz_t(), b.get_mpz_t(), a.get_mpz_t());
+    mpz_gcd(factor.get_mpz_t(), factor.get_mpz_t(), n.get_mpz_t());
 
-    startInterval += INTERVAL;
-    endInterval += INTERVAL;
+    if (factor != 1 && factor != n)
+      return factor;
   }
+
+  return 1;
 }
 
-mpz_class QuadraticSieve::solveLinearEquations(const mpz_class &n, const mpz_class &sqrtN,
-                                               const std::vector<uint32_t> &factorBase,
-                                               const std::vector<std::vector<uint32_t> > &factSmoothNumbers,
-                                               const std::vector<uint32_t> &smoothNumbers) {
-  Matrix M(factorBase.size(), factSmoothNumbers.size() + 1);
+mpz_class QuadraticSieve::solveLinearEquationsSparse(const mpz_class &n,
+                                                     const std::vector<uint32_t> &factorBase,
+                                                     const std::vector<Relation> &relations,
+                                                     const RelationFilter &filter) {
+  SparseMatrix B(filter.rows());
 
-  std::vector<mpz_class> bigSmoothNumbers;
-  mpz_class num;
-  for (const auto &i: smoothNumbers) {
-    mpz_add_ui(num.get_mpz_t(), sqrtN.get_mpz_t(), i);
-    bigSmoothNumbers.emplace_back(num);
+  for (uint32_t j = 0; j < filter.cols(); ++j) {
+    B.addColumn(filter.column(j));
   }
 
-  for (uint32_t i = 0; i < factSmoothNumbers.size(); ++i) {
-    for (uint32_t j = 0; j < factSmoothNumbers[i].size(); ++j) {
-      M(factSmoothNumbers[i][j], i).flip();
-    }
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    BlockLanczos lanczos(B);
+    const std::vector<uint64_t> dependencies = lanczos.solve();
+
+    if (!dependencies.empty())
+      return this->tryDependencies(n, factorBase, relations, filter, dependencies);
   }
 
-  M.reduce();
-  mpz_class a;
-  mpz_class b;
+  return 0;
+}
 
-  mpz_class temp_a = 0;
-  mpz_class temp_b = 20;
-  mpz_class temp_c = 30;
+mpz_class QuadraticSieve::solveLinearEquations(const mpz_class &n,
+                                               const std::vector<uint32_t> &factorBase,
+                                               const std::vector<Relation> &relations) {
+  // Relations, which can't be in dependency, and excess relations aren't in matrix
+  RelationFilter filter(relations, static_cast<uint32_t>(factorBase.size()));
+  filter.filter(filterExcess);
 
-  do {
-    std::vector<uint32_t> x = M.solve();
+  if (filter.cols() == 0)
+    return 1;
 
-    a = 1;
-    b = 1;
+  // Big matrix is sparse, it is solved with help of block Lanczos.
+  // If it fails, dense matrix is used.
+  if (factorBase.size() >= sparseMinFactorBase) {
+    const mpz_class factor = this->solveLinearEquationsSparse(n, factorBase, relations, filter);
+    if (factor != 0)
+      return factor;
+  }
 
-    std::vector<uint32_t> decomp(factorBase.size(), 0);
-    for (uint32_t i = 0; i < factSmoothNumbers.size(); ++i) {
-      if (x[i] == 1) {
-        for (const auto &p: factSmoothNumbers[i])
-          ++decomp[p];
+  Matrix M(filter.rows(), filter.cols());
 
-        mpz_mul(b.get_mpz_t(), b.get_mpz_t(), bigSmoothNumbers[i].get_mpz_t());
-      }
+  for (uint32_t j = 0; j < filter.cols(); ++j) {
+    for (const auto &i: filter.column(j)) {
+      M(i, j).flip();
     }
+  }
 
-    for (uint32_t p = 0; p < factorBase.size(); ++p) {
-      mpz_ui_pow_ui(num.get_mpz_t(), factorBase[p], decomp[p] / 2);
-      mpz_mul(a.get_mpz_t(), a.get_mpz_t(), num.get_mpz_t());
-    }
+  M.reduce();
 
-    mpz_mod(temp_b.get_mpz_t(), b.get_mpz_t(), n.get_mpz_t());
-    mpz_mod(temp_a.get_mpz_t(), a.get_mpz_t(), n.get_mpz_t());
-    mpz_mul_si(temp_c.get_mpz_t(), b.get_mpz_t(), -1);
-    mpz_mod(temp_c.get_mpz_t(), temp_c.get_mpz_t(), n.get_mpz_t());
-    mpz_add(temp_c.get_mpz_t(), temp_c.get_mpz_t(), n.get_mpz_t());
+  return this->tryDependencies(n, factorBase, relations, filter, M.nullspace());
+}
 
-  } while (mpz_cmp(temp_a.get_mpz_t(), temp_b.get_mpz_t()) == 0
-      || mpz_cmp(temp_a.get_mpz_t(), temp_c.get_mpz_t()) == 0);
+/**
+ * Sieving is done for kN, where k is Knuth-Schroeppel multiplier.
+ * Y^2 = Q (mod kN) is also true modulo N, so square roots and gcd are taken modulo N.
+ * Parameters are taken by digits of N, as rows of parameter table are tuned.
+ */
+mpz_class QuadraticSieve::factor(const mpz_class &n, uint32_t factorBaseScale) {
+  const mpz_class kn = n * this->chooseMultiplier(n);
+  const auto digits = static_cast<uint32_t>(mpz_sizeinbase(n.get_mpz_t(), 10));
+  SieveContext context(kn, sqrt(kn), ParameterTable::instance().get(digits));
 
-  mpz_class factor;
-  mpz_sub(factor.get_mpz_t(), b.get_mpz_t(), a.get_mpz_t());
-  mpz_gcd(factor.get_mpz_t(), factor.get_mpz_t(), n.get_mpz_t());
+  // Initialize data
+  this->createFactorBaseBySize(kn, context.factorBase, context.parameters.factorBaseSize * factorBaseScale);
+  this->solveShanksEquation(kn, context.sqrtN, context.factorBase, context.shanksRoots);
+  this->aproxFactorBase(context.factorBase, context.logFactorBase);
+
+  size_t count = context.factorBase.size() + extraRelations;
+  mpz_class factor = 1;
+
+  // Get B-Smooth numbers and solve system of linear equations Ax=0.
+  // If all dependencies are trivial, only few new relations are added.
+  for (uint32_t attempt = 0; attempt <= maxRetries && factor == 1; ++attempt) {
+    const bool complete = this->getSmoothNumbers(context, count);
+    factor = this->solveLinearEquations(n, context.factorBase, context.relations);
+    count = context.relations.size() + retryRelations;
+
+    // New relations can't be found, so larger factor base is tried
+    if (!complete)
+      break;
+  }
 
   return factor;
 }
 
-mpz_class QuadraticSieve::factor(const mpz_class &n, const mpz_class &sqrtN, uint32_t startFactorBase) {
+/**
+ * Every sieve sieves its own polynomials in its own thread, this thread sieves too
+ * and takes relations of other threads between its polynomials.
+ */
+void QuadraticSieve::collectRelations(std::vector<std::unique_ptr<SelfInitializingSieve> > &sieves, size_t count,
+                                      PartialRelations &partials, std::vector<Relation> &relations) {
+  RelationCollector collector;
+  SieveWorkers workers(collector);
+
+  for (size_t i = 1; i < sieves.size(); ++i)
+    workers.start(*sieves[i]);
+
+  // Failed worker stops collector, then its exception is thrown here
+  RelationCollector::Batch batch;
+  while (relations.size() < count && !collector.stopped()) {
+    sieves[0]->sievePolynomial(batch.relations, batch.partials);
+    RelationCollector::add(batch, partials, relations);
+    collector.drain(partials, relations);
+  }
+
+  workers.join();
+  workers.rethrow();
+
+  // Relations of the last polynomials aren't thrown away
+  collector.drain(partials, relations);
+}
+
+uint32_t QuadraticSieve::chooseMultiplier(const mpz_class &n) const {
+  const std::vector<uint32_t> primes(this->firstPrimes.begin(), this->firstPrimes.upTo(multiplierPrimesLimit));
+  return MathFunctions::knuth_schroeppel(n, primes);
+}
 
+mpz_class QuadraticSieve::factorSelfInitializing(const mpz_class &n, uint32_t factorBaseScale) {
   std::vector<uint32_t> factorBase;
-  std::vector<std::pair<uint32_t, uint32_t> > shanksRoots;
+  std::vector<Relation> relations;
 
-  std::vector<uint32_t> smoothNumbers;
-  std::vector<std::vector<uint32_t> > factSmoothNumbers;
+  // Relations are found for kN, but they are true modulo N too
+  const mpz_class kn = n * this->chooseMultiplier(n);
 
-  // Initialize data
-  this->createFactorBase(n, factorBase, startFactorBase);
-  this->solveShanksEquation(n, sqrtN, factorBase, shanksRoots);
+  const auto parameters = SelfInitializingSieve::getParameters(n);
+  this->createFactorBaseBySize(kn, factorBase, parameters.factorBaseSize * factorBaseScale);
 
-  // Get B-Smooth numbers
-  this->getSmoothNumbers(n, sqrtN, factorBase, shanksRoots, smoothNumbers, factSmoothNumbers);
+  // Get B-Smooth numbers from many polynomials, one sieve for every core.
+  // Sieves keep their state, so retry continues with the next polynomials.
+  const uint32_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<std::unique_ptr<SelfInitializingSieve> > sieves;
+  for (uint32_t i = 0; i < threads; ++i) {
+    sieves.emplace_back(new SelfInitializingSieve(kn, factorBase, parameters));
+    sieves.back()->setWorker(i, threads);
+  }
 
-  // Solve system of linear equations Ax=0,
-  // where A is matrix has size: factorBase.size(), factSmoothNumbers.size() + 1
-  mpz_class factor = this->solveLinearEquations(n, sqrtN, factorBase, factSmoothNumbers, smoothNumbers);
+  PartialRelations partials(kn);
+  size_t count = factorBase.size() + extraRelations;
+  mpz_class factor = 1;
+
+  for (uint32_t attempt = 0; attempt <= maxRetries && factor == 1; ++attempt) {
+    try {
+      this->collectRelations(sieves, count, partials, relations);
+    }
+    catch (std::invalid_argument &) {
+      // Sieves have no new polynomials, so larger factor base is tried
+      break;
+    }
+
+    factor = this->solveLinearEquations(n, factorBase, relations);
+    count = relations.size() + retryRelations;
+  }
 
   return factor;
 }
@@ -305,11 +572,9 @@ mpz_class QuadraticSieve::factor(const mpz_class &n, const mpz_class &sqrtN, uin
  * Solve equation Q = (x + sqrt(N)) - N
  */
 mpz_class QuadraticSieve::solveFactorBaseEquation(const mpz_class &n, const mpz_class &sqrtN, const uint32_t &x) {
-  mpz_class Q = x;
-  mpz_add(Q.get_mpz_t(), Q.get_mpz_t(), sqrtN.get_mpz_t());
-  mpz_pow_ui(Q.get_mpz_t(), Q.get_mpz_t(), 2);
-  mpz_sub(Q.get_mpz_t(),Q.get_mpz_t(), n.get_mpz_t());
-  return Q;
+  mpz_class y;
+  mpz_add_ui(y.get_mpz_t(), sqrtN.get_mpz_t(), x);
+  return y * y - n;
 }
 
 mpz_class QuadraticSieve::testsForSimplicitySolve(const mpz_class &n, const mpz_class &sqrtN) {
@@ -318,10 +583,9 @@ mpz_class QuadraticSieve::testsForSimplicitySolve(const mpz_class &n, const mpz_
     return sqrtN;
 
   // If N divide on one of first primary (about 5000), then return it primary
-  for (const auto& prime: this->firstPrimes){
-    if (mpz_divisible_ui_p(n.get_mpz_t(), prime))
-      return prime;
-  }
+  const uint32_t divider = this->firstPrimesTree_.smallestDivisor(n);
+  if (divider != 0)
+    return divider;
 
   // If N - primary, return 1
   int isPrime = mpz_probab_prime_p(n.get_mpz_t(), 10);
@@ -350,33 +614,32 @@ mpz_class QuadraticSieve::factorNumber(const mpz_class &n) {
     return testResult;
   }
 
-  // The experimentally obtained value
-  const mpz_class thresholdSizeFactorBase("10000000", 10);
-
-  mpz_class ans = factor(n, sqrtN);
+  // Large numbers are factorized with help of many polynomials
+  if (mpz_sizeinbase(n.get_mpz_t(), 10) >= ParameterTable::siqsMinDigits) {
+    mpz_class ans = factorSelfInitializing(n);
 
-  if (mpz_cmp(sqrtN.get_mpz_t(), thresholdSizeFactorBase.get_mpz_t()) < 0 && ans == 1){
-    ans = factor(n, sqrtN, sqrtN.get_ui());
-  }
+    if (ans == 1) {
+      ans = factorSelfInitializing(n, retryFactorBaseScale);
+    }
 
-  if (ans == 1){
-    for (int i = 0; i < 2; i++){
-      ans = factor(n, sqrtN);
-      if (ans != 1)
-        break;
+    ul.lock();
+    if (this->storage_.find(n) == this->storage_.end()) {
+      this->storage_[n] = ans;
     }
+    ul.unlock();
+
+    return ans;
   }
 
-  if (ans == 1 && mpz_cmp(sqrtN.get_mpz_t(), thresholdSizeFactorBase.get_mpz_t()) < 0){
-    for (int i = 0; i < 2; i++){
-      ans = factor(n, sqrtN, sqrtN.get_ui());
-      if (ans != 1)
-        break;
-    }
+  // Relations are reused between attempts inside factor(), so only bigger factor base is tried after it
+  mpz_class ans = factor(n);
+
+  if (ans == 1) {
+    ans = factor(n, retryFactorBaseScale);
   }
 
   ul.lock();
-  if (this->storage_.find(n) != this->storage_.end()) {
+  if (this->storage_.find(n) == this->storage_.end()) {
     this->storage_[n] = ans;
   }
   ul.unlock();
@@ -13,7 +13,13 @@
 #ifndef OOP_4_AND_5_QUADRATICSIEVE_H
 #define OOP_4_AND_5_QUADRATICSIEVE_H
 
-#include <AtkinSieve/AtkinSieve.h>
+#include <PrimeTable/PrimeTable.h>
+#include <ParameterTable/ParameterTable.h>
+#include <ProductTree/ProductTree.h>
+#include <Relation/Relation.h>
+#include <PartialRelations/PartialRelations.h>
+#include <RelationFilter/RelationFilter.h>
+#include <SelfInitializingSieve/SelfInitializingSieve.h>
 #include <gmpxx.h>
 #include <gmp.h>
 #include <memory>
@@ -28,58 +34,111 @@ class QuadraticSieve final{
   mpz_class factorNumber(const mpz_class &n);
 
  private:
-  void createFactorBase(const mpz_class &n, std::vector<uint32_t> &factorBase,  uint32_t startFactorBaseSize);
-  void filterFactorBase(const mpz_class &n, std::vector<uint32_t> &factorBase);
-  void aproxFactorBase(const std::vector<uint32_t> &factorBase, std::vector<double> &logFactorBase);
+  // Everything, which is collected for one N. It lives while attempts of linear algebra
+  // are repeated, so failed attempt costs only few new relations.
+  struct SieveContext {
+    SieveContext(const mpz_class &n, const mpz_class &sqrtN, const ParameterTable::Parameters &parameters)
+        : n(n), sqrtN(sqrtN), parameters(parameters), partials(n) {}
+
+    const mpz_class n;
+    const mpz_class sqrtN;
+    const ParameterTable::Parameters parameters;
+
+    std::vector<uint32_t> factorBase;
+    std::vector<uint8_t> logFactorBase;
+    std::vector<std::pair<uint32_t, uint32_t> > shanksRoots;
+
+    PartialRelations partials;
+    std::vector<Relation> relations;
+
+    // Position of sieving
+    uint32_t startInterval = 0;
+  };
+
+  void createFactorBaseBySize(const mpz_class &n, std::vector<uint32_t> &factorBase, uint32_t factorBaseSize);
+  void aproxFactorBase(const std::vector<uint32_t> &factorBase, std::vector<uint8_t> &logFactorBase);
   void solveShanksEquation(const mpz_class &n, const mpz_class &sqrtN,
                            const std::vector<uint32_t> &factorBase,
                            std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots);
 
   mpz_class solveFactorBaseEquation(const mpz_class &n, const mpz_class &sqrtN, const uint32_t& x);
 
-  void getSmoothNumbers(const mpz_class &n, const mpz_class &sqrtN,
-                        const std::vector<uint32_t> &factorBase,
-                        std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
-                        std::vector<uint32_t> &smoothNumbers,
-                        std::vector<std::vector<uint32_t> > &factSmoothNumbers);
+  // Sieve until context has 'count' relations, return false, if sieve has stopped before on maxSieveIntervals
+  bool getSmoothNumbers(SieveContext &context, size_t count);
 
   void generateAproxForInterval(const mpz_class &n, const mpz_class &sqrtN,
-                                const uint32_t &startInterval, const uint32_t &interval,
-                                std::vector<double> &approx,
-                                double &prevLogEstimate,
-                                uint32_t &nextLogEstimate);
+                                const uint32_t &startInterval,
+                                const uint32_t &endInterval,
+                                const double &threshold,
+                                std::vector<uint8_t> &sieve);
 
   void sieveNumbersForInterval(const uint32_t &startInterval,
                                const uint32_t &endInterval,
                                const std::vector<uint32_t> &factorBase,
-                               const std::vector<double> &logFactorBase,
-                               std::vector<double> &approx,
+                               const std::vector<uint8_t> &logFactorBase,
+                               std::vector<uint8_t> &sieve,
                                std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots);
 
+  // hits[c] are indices of primes, which divide Q(x) of candidate with position positions[c]
+  void resieveCandidates(const uint32_t &startInterval,
+                         const std::vector<uint32_t> &factorBase,
+                         const std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
+                         const std::vector<uint8_t> &sieve,
+                         const std::vector<uint32_t> &positions,
+                         std::vector<std::vector<uint32_t> > &hits);
+
   void getNumbersBelowThreshold(const mpz_class &n, const mpz_class &sqrtN,
-                                const uint32_t &startInterval, const uint32_t &interval,
-                                const double &threshold,
+                                const uint32_t &startInterval,
                                 const std::vector<uint32_t> &factorBase,
-                                const std::vector<double> &approx,
-                                std::vector<uint32_t> &smoothNumbers,
-                                std::vector<std::vector<uint32_t> > &factSmoothNumbers);
+                                const std::vector<std::pair<uint32_t, uint32_t> > &shanksRoots,
+                                const std::vector<uint8_t> &sieve,
+                                const uint64_t &largePrimeBound,
+                                size_t count,
+                                PartialRelations &partials,
+                                std::vector<Relation> &relations);
+
+  void findSquareRoots(const mpz_class &n,
+                       const std::vector<uint32_t> &factorBase,
+                       const std::vector<Relation> &relations,
+                       const std::vector<uint32_t> &x,
+                       mpz_class &a, mpz_class &b);
+
+  // Try every dependency in turn, return 1 if all of them give trivial factor
+  mpz_class tryDependencies(const mpz_class &n,
+                            const std::vector<uint32_t> &factorBase,
+                            const std::vector<Relation> &relations,
+                            const RelationFilter &filter,
+                            const std::vector<uint64_t> &dependencies);
+
+  mpz_class solveLinearEquations(const mpz_class &n,
+                                 const std::vector<uint32_t> &factorBase,
+                                 const std::vector<Relation> &relations);
 
-  mpz_class factorSmallNumber(const std::vector<uint32_t> &factorBase,
-                              std::vector<uint32_t> &factors, mpz_class number);
+  mpz_class solveLinearEquationsSparse(const mpz_class &n,
+                                       const std::vector<uint32_t> &factorBase,
+                                       const std::vector<Relation> &relations,
+                                       const RelationFilter &filter);
 
-  mpz_class solveLinearEquations(const mpz_class &n, const mpz_class &sqrtN,
-                                 const std::vector<uint32_t> &factorBase,
-                                 const std::vector<std::vector<uint32_t> > &factSmoothNumbers,
-                                 const std::vector<uint32_t> &smoothNumbers);
+  // Factor base size from parameter table is multiplied by factorBaseScale
+  mpz_class factor(const mpz_class &n, uint32_t factorBaseScale = 1);
 
-  mpz_class factor(const mpz_class &n, const mpz_class &sqrtN, uint32_t startFactorBase = 300);
+  // Knuth-Schroeppel multiplier k: kN is sieved instead of N
+  uint32_t chooseMultiplier(const mpz_class &n) const;
+
+  mpz_class factorSelfInitializing(const mpz_class &n, uint32_t factorBaseScale = 1);
+
+  // Sieve in all sieves in parallel, until relations has at least 'count' elements
+  void collectRelations(std::vector<std::unique_ptr<SelfInitializingSieve> > &sieves, size_t count,
+                        PartialRelations &partials, std::vector<Relation> &relations);
 
   mpz_class testsForSimplicitySolve(const mpz_class &n, const mpz_class& sqrtN);
 
-  AtkinSieve atkinSieve_;
   std::mutex m_;
   std::map<mpz_class, mpz_class> storage_;
-  std::vector<uint32_t> firstPrimes;
+
+  // Shared table, which has primes for trial division
+  const PrimeTable::Snapshot &firstPrimes;
+  const ProductTree firstPrimesTree_;
 };
 
 #endif //OOP_4_AND_5_QUADRATICSIEVE_H
@@ -0,0 +1,39 @@
+/**
+ * @file Relation.h
+ * Relation which was found by sieving:
+ *     Y^2 = Q (mod N), where Q is smooth over factor base
+ *     (except square of largeFactor for combined partial relations).
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 02.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_RELATION_H
+#define OOP_4_AND_5_RELATION_H
+
+#include <cstdint>
+#include <vector>
+#include <gmpxx.h>
+
+struct Relation {
+  // Number Y, which square is congruent Q modulo N
+  mpz_class y;
+
+  // Indexes of factor base primes, which divide Q (with multiplicity)
+  std::vector<uint32_t> factors;
+
+  // Q is negative number
+  bool negative;
+
+  // Product of large primes out of factor base, which square divides Q
+  mpz_class largeFactor = 1;
+};
+
+// Relation, where Q has one or two large primes out of factor base (secondPrime = 1 for one prime)
+struct PartialRelation {
+  Relation relation;
+  uint64_t firstPrime;
+  uint64_t secondPrime;
+};
+
+#endif //OOP_4_AND_5_RELATION_H
@@ -0,0 +1,83 @@
+/**
+ * @file RelationCollector.cpp
+ * Relations from many sieve threads for one N.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 17.12.2017
+ * @version 1.0
+ */
+#include <RelationCollector/RelationCollector.h>
+
+#include <memory>
+#include <utility>
+
+RelationCollector::RelationCollector() : head_(nullptr), stopped_(false) {}
+
+RelationCollector::~RelationCollector() {
+  Node *node = this->head_.load();
+  while (node != nullptr) {
+    Node *next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+void RelationCollector::push(Batch batch) {
+  // Most polynomials give nothing, node isn't allocated for them
+  if (batch.relations.empty() && batch.partials.empty())
+    return;
+
+  auto node = new Node{std::move(batch), this->head_.load(std::memory_order_relaxed)};
+
+  while (!this->head_.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                            std::memory_order_relaxed)) {}
+}
+
+bool RelationCollector::stopped() const {
+  return this->stopped_.load(std::memory_order_acquire);
+}
+
+void RelationCollector::stop() {
+  this->stopped_.store(true, std::memory_order_release);
+}
+
+void RelationCollector::drain(PartialRelations &partials, std::vector<Relation> &relations) {
+  Node *node = this->head_.exchange(nullptr, std::memory_order_acquire);
+
+  // Stack gives batches in reverse order
+  Node *reversed = nullptr;
+  while (node != nullptr) {
+    Node *next = node->next;
+    node->next = reversed;
+    reversed = node;
+    node = next;
+  }
+
+  // Nodes are freed, even if add throws
+  while (reversed != nullptr) {
+    std::unique_ptr<Node> current(reversed);
+    reversed = reversed->next;
+
+    try {
+      add(current->batch, partials, relations);
+    } catch (...) {
+      while (reversed != nullptr) {
+        Node *next = reversed->next;
+        delete reversed;
+        reversed = next;
+      }
+      throw;
+    }
+  }
+}
+
+void RelationCollector::add(Batch &batch, PartialRelations &partials, std::vector<Relation> &relations) {
+  for (auto &relation: batch.relations)
+    relations.emplace_back(std::move(relation));
+
+  for (auto &partial: batch.partials)
+    partials.addRelation(std::move(partial.relation), partial.firstPrime, partial.secondPrime, relations);
+
+  batch.relations.clear();
+  batch.partials.clear();
+}
@@ -0,0 +1,56 @@
+/**
+ * @file RelationCollector.h
+ * Relations from many sieve threads for one N.
+ * Workers push their batches to lock-free stack, one thread drains it,
+ * combines partial relations and decides, when relations are enough to stop all workers.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 17.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_RELATIONCOLLECTOR_H
+#define OOP_4_AND_5_RELATIONCOLLECTOR_H
+
+#include <atomic>
+#include <vector>
+
+#include <Relation/Relation.h>
+#include <PartialRelations/PartialRelations.h>
+
+class RelationCollector final {
+
+ public:
+  // Relations of one or several polynomials
+  struct Batch {
+    std::vector<Relation> relations;
+    std::vector<PartialRelation> partials;
+  };
+
+  RelationCollector();
+  ~RelationCollector();
+  RelationCollector(const RelationCollector &) = delete;
+  RelationCollector &operator=(const RelationCollector &) = delete;
+
+  // It can be called from any thread. Empty batch is skipped.
+  void push(Batch batch);
+
+  bool stopped() const;
+  void stop();
+
+  // Move all pushed batches to relations, partial relations are combined in partials.
+  // Only one thread can drain collector.
+  void drain(PartialRelations &partials, std::vector<Relation> &relations);
+
+  static void add(Batch &batch, PartialRelations &partials, std::vector<Relation> &relations);
+
+ private:
+  struct Node {
+    Batch batch;
+    Node *next;
+  };
+
+  std::atomic<Node *> head_;
+  std::atomic<bool> stopped_;
+};
+
+#endif //OOP_4_AND_5_RELATIONCOLLECTOR_H
@@ -0,0 +1,221 @@
+/**
+ * @file RelationFilter.cpp
+ * Filtering of relations before building of matrix.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 09.12.2017
+ * @version 1.0
+ */
+#include <RelationFilter/RelationFilter.h>
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+  // Every round of clique removal is followed by removal of new singletons
+  const uint32_t maxCliqueRounds = 20;
+
+  uint32_t findRoot(std::vector<uint32_t> &parent, uint32_t x) {
+    while (parent[x] != x) {
+      parent[x] = parent[parent[x]];
+      x = parent[x];
+    }
+    return x;
+  }
+
+}
+
+RelationFilter::RelationFilter(const std::vector<Relation> &relations, uint32_t factorBaseSize)
+    : columns_(relations.size()),
+      rowRelations_(factorBaseSize + 1),
+      weight_(factorBaseSize + 1, 0),
+      alive_(relations.size(), 1),
+      aliveCount_(static_cast<uint32_t>(relations.size())),
+      rows_(0) {
+
+  std::vector<uint32_t> rows;
+
+  for (uint32_t i = 0; i < relations.size(); ++i) {
+    rows = relations[i].factors;
+    if (relations[i].negative) {
+      rows.emplace_back(factorBaseSize);
+    }
+    std::sort(rows.begin(), rows.end());
+
+    // Only primes with odd exponent are in matrix
+    auto &column = this->columns_[i];
+    for (size_t j = 0; j < rows.size();) {
+      size_t k = j;
+      while (k < rows.size() && rows[k] == rows[j])
+        ++k;
+
+      if ((k - j) % 2 == 1) {
+        column.emplace_back(rows[j]);
+        this->rowRelations_[rows[j]].emplace_back(i);
+        ++this->weight_[rows[j]];
+      }
+
+      j = k;
+    }
+  }
+}
+
+void RelationFilter::filter(uint32_t excess) {
+  this->removeSingletons();
+
+  for (uint32_t round = 0; round < maxCliqueRounds && this->removeCliques(excess); ++round) {
+    this->removeSingletons();
+  }
+
+  this->renumberRows();
+}
+
+uint32_t RelationFilter::rows() const {
+  return this->rows_;
+}
+
+uint32_t RelationFilter::cols() const {
+  return static_cast<uint32_t>(this->kept_.size());
+}
+
+uint32_t RelationFilter::relationIndex(uint32_t col) const {
+  return this->kept_[col];
+}
+
+const std::vector<uint32_t> &RelationFilter::column(uint32_t col) const {
+  return this->columns_[this->kept_[col]];
+}
+
+void RelationFilter::removeRelation(uint32_t relation) {
+  this->alive_[relation] = 0;
+  --this->aliveCount_;
+
+  for (const auto &row: this->columns_[relation]) {
+    --this->weight_[row];
+  }
+}
+
+uint32_t RelationFilter::activeRows() const {
+  return static_cast<uint32_t>(std::count_if(this->weight_.begin(), this->weight_.end(),
+                                             [](uint32_t weight) { return weight > 0; }));
+}
+
+/**
+ * Relation with prime, which is in no other relation, can't be in any dependency.
+ * Its removal can make new singletons, so they are processed with help of stack.
+ */
+void RelationFilter::removeSingletons() {
+  std::vector<uint32_t> stack;
+
+  for (uint32_t row = 0; row < this->weight_.size(); ++row) {
+    if (this->weight_[row] == 1)
+      stack.emplace_back(row);
+  }
+
+  while (!stack.empty()) {
+    const uint32_t row = stack.back();
+    stack.pop_back();
+
+    if (this->weight_[row] != 1)
+      continue;
+
+    for (const auto &relation: this->rowRelations_[row]) {
+      if (!this->alive_[relation])
+        continue;
+
+      this->removeRelation(relation);
+      for (const auto &other: this->columns_[relation]) {
+        if (this->weight_[other] == 1)
+          stack.emplace_back(other);
+      }
+      break;
+    }
+  }
+}
+
+/**
+ * Relations, which are linked by primes with weight 2, form clique.
+ * Removal of clique with k relations removes at least k - 1 rows, so excess decreases at most by one.
+ * The largest cliques are removed first, because they give the biggest part of matrix.
+ */
+bool RelationFilter::removeCliques(uint32_t excess) {
+  const uint32_t rows = this->activeRows();
+  if (this->aliveCount_ <= rows + excess)
+    return false;
+
+  std::vector<uint32_t> parent(this->columns_.size());
+  std::iota(parent.begin(), parent.end(), 0);
+
+  for (uint32_t row = 0; row < this->weight_.size(); ++row) {
+    if (this->weight_[row] != 2)
+      continue;
+
+    uint32_t ends[2];
+    uint32_t count = 0;
+    for (const auto &relation: this->rowRelations_[row]) {
+      if (this->alive_[relation])
+        ends[count++] = relation;
+    }
+
+    parent[findRoot(parent, ends[0])] = findRoot(parent, ends[1]);
+  }
+
+  std::vector<uint32_t> size(this->columns_.size(), 0);
+  for (uint32_t i = 0; i < this->columns_.size(); ++i) {
+    if (this->alive_[i])
+      ++size[findRoot(parent, i)];
+  }
+
+  std::vector<uint32_t> cliques;
+  for (uint32_t i = 0; i < this->columns_.size(); ++i) {
+    if (size[i] > 0)
+      cliques.emplace_back(i);
+  }
+
+  const uint32_t count = std::min<uint32_t>(static_cast<uint32_t>(cliques.size()),
+                                            this->aliveCount_ - rows - excess);
+  std::partial_sort(cliques.begin(), cliques.begin() + count, cliques.end(),
+                    [&size](uint32_t x, uint32_t y) { return size[x] > size[y]; });
+
+  std::vector<char> removed(this->columns_.size(), 0);
+  for (uint32_t i = 0; i < count; ++i) {
+    removed[cliques[i]] = 1;
+  }
+
+  for (uint32_t i = 0; i < this->columns_.size(); ++i) {
+    if (this->alive_[i] && removed[findRoot(parent, i)])
+      this->removeRelation(i);
+  }
+
+  return count > 0;
+}
+
+/**
+ * Rows, which are left in matrix, get numbers 0 ... rows() - 1.
+ * Memory of removed relations is freed.
+ */
+void RelationFilter::renumberRows() {
+  std::vector<uint32_t> index(this->weight_.size(), 0);
+
+  this->rows_ = 0;
+  for (uint32_t row = 0; row < this->weight_.size(); ++row) {
+    if (this->weight_[row] > 0)
+      index[row] = this->rows_++;
+  }
+
+  this->kept_.clear();
+  for (uint32_t i = 0; i < this->columns_.size(); ++i) {
+    if (!this->alive_[i]) {
+      std::vector<uint32_t>().swap(this->columns_[i]);
+      continue;
+    }
+
+    for (auto &row: this->columns_[i]) {
+      row = index[row];
+    }
+    this->kept_.emplace_back(i);
+  }
+
+  std::vector<std::vector<uint32_t> >().swap(this->rowRelations_);
+}
@@ -0,0 +1,63 @@
+/**
+ * @file RelationFilter.h
+ * Filtering of relations before building of matrix:
+ *     - relation with prime, which appears only once, can't be in dependency (singleton removal);
+ *     - excess relations are removed together with primes, which link them (clique removal);
+ *     - remaining primes are renumbered into compact row index.
+ * Description:
+ * https://link.springer.com/content/pdf/10.1007/3-540-45539-6_1.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 09.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_RELATIONFILTER_H
+#define OOP_4_AND_5_RELATIONFILTER_H
+
+#include <vector>
+
+#include <Relation/Relation.h>
+
+class RelationFilter final {
+
+ public:
+  // Rows of matrix are primes of factor base and sign of Q (row number factorBaseSize)
+  RelationFilter(const std::vector<Relation> &relations, uint32_t factorBaseSize);
+  RelationFilter(const RelationFilter &) = delete;
+  RelationFilter &operator=(const RelationFilter &) = delete;
+
+  // Remove singletons and cliques, while count of relations is more then rows() + excess
+  void filter(uint32_t excess);
+
+  // Size of matrix after filtering
+  uint32_t rows() const;
+  uint32_t cols() const;
+
+  // Index of relation, which is in column col
+  uint32_t relationIndex(uint32_t col) const;
+
+  // Compact rows with odd exponent in column col
+  const std::vector<uint32_t> &column(uint32_t col) const;
+
+ private:
+  void removeRelation(uint32_t relation);
+  void removeSingletons();
+  bool removeCliques(uint32_t excess);
+  void renumberRows();
+
+  uint32_t activeRows() const;
+
+  // Rows with odd exponent for every relation
+  std::vector<std::vector<uint32_t> > columns_;
+
+  // Relations, which contain row
+  std::vector<std::vector<uint32_t> > rowRelations_;
+  std::vector<uint32_t> weight_;
+  std::vector<char> alive_;
+  uint32_t aliveCount_;
+
+  std::vector<uint32_t> kept_;
+  uint32_t rows_;
+};
+
+#endif //OOP_4_AND_5_RELATIONFILTER_H
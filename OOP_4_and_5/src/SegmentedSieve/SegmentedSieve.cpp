@@ -0,0 +1,94 @@
+/**
+ * @file SegmentedSieve.cpp
+ * Segmented sieve of Eratosthenes for range [low, high].
+ * @href https://en.wikipedia.org/wiki/Sieve_of_Eratosthenes#Segmented_sieve
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 12.12.2017
+ * @version 1.0
+ */
+#include <SegmentedSieve/SegmentedSieve.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+  uint64_t isqrt(uint64_t n) {
+    auto r = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && (r > UINT32_MAX || r * r > n))
+      --r;
+    while (r < UINT32_MAX && (r + 1) * (r + 1) <= n)
+      ++r;
+    return r;
+  }
+
+}
+
+SegmentedSieve::SegmentedSieve(uint64_t low, uint64_t high, uint32_t blockSize)
+    : low_(low), high_(high), blockSize_(blockSize), current_(low & ~1ull), finished_(high < low),
+      sievingPrimes_(smallPrimes(high)), block_(blockSize) {
+
+  this->nextMultiple_.reserve(this->sievingPrimes_.size());
+
+  // Composite numbers from range have odd multiple of p, which is not less then p^2
+  for (const auto &p: this->sievingPrimes_) {
+    const uint64_t square = static_cast<uint64_t>(p) * p;
+    uint64_t start = std::max(square, (this->current_ + p) / p * p);
+    if ((start & 1) == 0)
+      start += p;
+    this->nextMultiple_.emplace_back(start);
+  }
+}
+
+std::vector<uint32_t> SegmentedSieve::smallPrimes(uint64_t limit) {
+  const auto root = static_cast<uint32_t>(isqrt(limit));
+  std::vector<char> composite(root + 1, 0);
+  std::vector<uint32_t> primes;
+
+  for (uint32_t i = 3; i <= root; i += 2) {
+    if (composite[i])
+      continue;
+
+    primes.emplace_back(i);
+    for (uint64_t j = static_cast<uint64_t>(i) * i; j <= root; j += 2 * i)
+      composite[j] = 1;
+  }
+
+  return primes;
+}
+
+bool SegmentedSieve::next(std::vector<uint64_t> &primes) {
+  primes.clear();
+
+  if (this->finished_)
+    return false;
+
+  if (this->current_ <= 2 && this->low_ <= 2 && this->high_ >= 2)
+    primes.emplace_back(2);
+
+  // Block has odd numbers current_ + 1, current_ + 3, ... less then end
+  const uint64_t end = std::min<uint64_t>(this->high_ + 1, this->current_ + 2ull * this->blockSize_);
+  const auto count = static_cast<uint32_t>((end - this->current_) / 2);
+  std::fill(this->block_.begin(), this->block_.begin() + count, 1);
+
+  for (size_t k = 0; k < this->sievingPrimes_.size(); ++k) {
+    const uint64_t step = 2ull * this->sievingPrimes_[k];
+    uint64_t multiple = this->nextMultiple_[k];
+
+    for (; multiple < end; multiple += step)
+      this->block_[(multiple - this->current_) / 2] = 0;
+
+    this->nextMultiple_[k] = multiple;
+  }
+
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint64_t number = this->current_ + 2ull * i + 1;
+    if (this->block_[i] && number >= this->low_ && number > 1)
+      primes.emplace_back(number);
+  }
+
+  this->current_ += 2ull * this->blockSize_;
+  this->finished_ = end > this->high_;
+  return true;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file SegmentedSieve.h
+ * Segmented sieve of Eratosthenes for range [low, high].
+ * Only odd numbers are stored, range is sieved in blocks, which fit in L2 cache,
+ * so memory doesn't depend on size of range. Primes are produced block by block.
+ * @href https://en.wikipedia.org/wiki/Sieve_of_Eratosthenes#Segmented_sieve
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 12.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_SEGMENTEDSIEVE_H
+#define OOP_4_AND_5_SEGMENTEDSIEVE_H
+
+#include <cstdint>
+#include <vector>
+
+class SegmentedSieve final {
+
+ public:
+  // Bytes in one block, every byte is one odd number
+  static const uint32_t defaultBlockSize = 1u << 18;
+
+  SegmentedSieve(uint64_t low, uint64_t high, uint32_t blockSize = defaultBlockSize);
+  SegmentedSieve(const SegmentedSieve &) = delete;
+  SegmentedSieve &operator=(const SegmentedSieve &) = delete;
+
+  // Primes of next block in ascending order. Return false, if whole range was sieved.
+  bool next(std::vector<uint64_t> &primes);
+
+  // Odd primes, which are not more then sqrt(limit)
+  static std::vector<uint32_t> smallPrimes(uint64_t limit);
+
+ private:
+  uint64_t low_;
+  uint64_t high_;
+  uint32_t blockSize_;
+
+  // Next block starts from this even number
+  uint64_t current_;
+  bool finished_;
+
+  std::vector<uint32_t> sievingPrimes_;
+
+  // Next odd multiple of every sieving prime, which isn't crossed off yet
+  std::vector<uint64_t> nextMultiple_;
+
+  // block_[i] is 1, if current_ + 2 * i + 1 can be prime
+  std::vector<uint8_t> block_;
+};
+
+#endif //OOP_4_AND_5_SEGMENTEDSIEVE_H
@@ -0,0 +1,537 @@
+/**
+ * @file SelfInitializingSieve.cpp
+ * Self-initializing quadratic sieve (SIQS).
+ * Description:
+ * https://en.wikipedia.org/wiki/Quadratic_sieve#Multiple_polynomials
+ * http://www.crypto-world.com/documents/contini_siqs.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 02.12.2017
+ * @version 1.0
+ */
+#include <SelfInitializingSieve/SelfInitializingSieve.h>
+#include <MathFunctions/MathFunctions.h>
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <SieveScanner/SieveScanner.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+  // Primes less then it give small contribution to sieve, so they are skipped
+  const uint32_t minSievePrime = 30;
+
+  // Window of factors of 'a' is doubled every attemptsPerSpread attempts, search stops after maxAttemptsA
+  const uint32_t attemptsPerSpread = 64;
+  const uint32_t maxAttemptsA = 1024;
+
+  double log2Number(const mpz_class &n) {
+    long exponent = 0;
+    const double d = mpz_get_d_2exp(&exponent, n.get_mpz_t());
+    return exponent + std::log2(d);
+  }
+
+  uint64_t toUint64(const mpz_class &n) {
+    uint64_t result = 0;
+    mpz_export(&result, nullptr, -1, sizeof(result), 0, 0, n.get_mpz_t());
+    return result;
+  }
+
+}
+
+SelfInitializingSieve::SelfInitializingSieve(const mpz_class &n, const std::vector<uint32_t> &factorBase,
+                                             const Parameters &parameters, uint32_t blockSize)
+    : n_(n), factorBase_(factorBase), parameters_(parameters),
+      polynomials_(0), polynomialIndex_(0), worker_(0), workers_(1), random_(std::random_device()()) {
+
+  this->solveShanksEquation();
+  this->aproxFactorBase();
+
+  this->startSieveIndex_ = 0;
+  while (this->startSieveIndex_ < this->factorBase_.size() &&
+      this->factorBase_[this->startSieveIndex_] < minSievePrime) {
+    ++this->startSieveIndex_;
+  }
+
+  // Block size is rounded down to power of two
+  this->blockBits_ = 0;
+  const uint32_t size = blockSize != 0 ? blockSize : SieveScanner::default_block_size();
+  while ((2u << this->blockBits_) <= size)
+    ++this->blockBits_;
+
+  this->largeSieveIndex_ = this->startSieveIndex_;
+  while (this->largeSieveIndex_ < this->factorBase_.size() &&
+      this->factorBase_[this->largeSieveIndex_] < (1u << this->blockBits_)) {
+    ++this->largeSieveIndex_;
+  }
+
+  // max|Q(x)| on [-M, M) is about M * sqrt(N / 2)
+  this->logEstimate_ = std::log2(this->parameters_.halfInterval) + log2Number(n) / 2 - 0.5;
+  this->threshold_ = this->parameters_.thresholdFactor * this->logFactorBase_.back();
+  // Bound isn't more then (max prime)^2, see addPartialRelation
+  const uint64_t maxPrime = this->factorBase_.back();
+  this->largePrimeBound_ = std::min({maxPrime * this->parameters_.largePrimeMultiplier, maxPrime * maxPrime,
+                                     static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())});
+}
+
+SelfInitializingSieve::Parameters SelfInitializingSieve::getParameters(const mpz_class &n) {
+  const auto digits = static_cast<uint32_t>(mpz_sizeinbase(n.get_mpz_t(), 10));
+  return ParameterTable::instance().get(digits);
+}
+
+void SelfInitializingSieve::solveShanksEquation() {
+  MathFunctions::sqrt_mod(this->n_, this->factorBase_, this->sqrtN_);
+}
+
+void SelfInitializingSieve::aproxFactorBase() {
+  this->logFactorBase_.clear();
+
+  this->sieveLogs_.clear();
+
+  for (const auto &p: this->factorBase_) {
+    this->logFactorBase_.emplace_back(std::log2(p));
+    this->sieveLogs_.emplace_back(SieveScanner::scaled_log(p));
+  }
+}
+
+/**
+ * Choose a = q_1 * ... * q_s close to sqrt(2N) / M,
+ * where q_j are primes of factor base. Every 'a' is used only once.
+ * Primes of multiplier divide N and have no square root of N, so they aren't factors of 'a'.
+ * If factor base is too small, or all its 'a' are used, std::invalid_argument is thrown.
+ */
+void SelfInitializingSieve::generatePolynomialA() {
+  const double logTarget = (log2Number(this->n_) + 1) / 2 - std::log2(this->parameters_.halfInterval);
+
+  const auto low = static_cast<int64_t>(std::max<uint32_t>(this->startSieveIndex_, 1));
+  const auto high = static_cast<int64_t>(this->factorBase_.size());
+
+  const double logMin = this->logFactorBase_[low];
+  const double logMax = this->logFactorBase_[high - 1];
+
+  // Factors of 'a' are near 2^11, but they must be in factor base
+  auto s = static_cast<uint32_t>(std::max(1.0, std::round(logTarget / 11)));
+  while (s > 1 && logTarget / s < logMin + 1)
+    --s;
+  while (logTarget / s > logMax - 1)
+    ++s;
+
+  const double ideal = std::pow(2, logTarget / s);
+  const auto idealIndex = std::min<int64_t>(high - 1, std::max<int64_t>(low,
+      std::lower_bound(this->factorBase_.begin(), this->factorBase_.end(), ideal) - this->factorBase_.begin()));
+
+  int64_t spread = std::max<int64_t>(4 * s, 8);
+
+  for (uint32_t attempt = 1; attempt <= maxAttemptsA; ++attempt) {
+    if (attempt % attemptsPerSpread == 0)
+      spread *= 2;
+
+    // Window has one prime of multiplier at most, the others can be factors of 'a'
+    const int64_t windowLow = std::max(low, idealIndex - spread);
+    const int64_t windowHigh = std::min(high, idealIndex + spread);
+    if (windowHigh - windowLow <= s)
+      continue;
+
+    std::uniform_int_distribution<int64_t> dist(windowLow, windowHigh - 1);
+    std::vector<uint32_t> chosen;
+    double logRest = logTarget;
+
+    while (chosen.size() + 1 < s) {
+      const auto index = static_cast<uint32_t>(dist(this->random_));
+      if (this->sqrtN_[index] == 0 || std::find(chosen.begin(), chosen.end(), index) != chosen.end())
+        continue;
+
+      chosen.emplace_back(index);
+      logRest -= this->logFactorBase_[index];
+    }
+
+    // Last factor approximates target as close as possible
+    const double rest = std::pow(2, std::min(logRest, 32.0));
+    const auto nearest = std::min<int64_t>(high - 1, std::max<int64_t>(low,
+        std::lower_bound(this->factorBase_.begin(), this->factorBase_.end(), rest) - this->factorBase_.begin()));
+
+    for (int64_t offset = 0; offset < high - low; ++offset) {
+      const int64_t index = offset % 2 == 0 ? nearest + offset / 2 : nearest - offset / 2 - 1;
+      if (index < low || index >= high || this->sqrtN_[index] == 0)
+        continue;
+
+      std::vector<uint32_t> key(chosen);
+      if (std::find(key.begin(), key.end(), index) != key.end())
+        continue;
+
+      key.emplace_back(static_cast<uint32_t>(index));
+      std::sort(key.begin(), key.end());
+
+      if (this->usedA_.find(key) != this->usedA_.end() || !this->ownsA(key))
+        continue;
+
+      this->usedA_.emplace(key);
+      this->aFactors_ = key;
+      return;
+    }
+  }
+
+  throw std::invalid_argument("Factor base is too small for new polynomial");
+}
+
+/**
+ * Find b for chosen a, so b^2 = N (mod a),
+ * and roots of Q(x) = 0 (mod p) for all primes of factor base.
+ */
+void SelfInitializingSieve::initializePolynomial() {
+  const uint32_t s = static_cast<uint32_t>(this->aFactors_.size());
+  const uint32_t M = this->parameters_.halfInterval;
+
+  this->a_ = 1;
+  for (const auto &index: this->aFactors_) {
+    mpz_mul_ui(this->a_.get_mpz_t(), this->a_.get_mpz_t(), this->factorBase_[index]);
+  }
+
+  this->isFactorA_.assign(this->factorBase_.size(), false);
+  this->B_.assign(s, 0);
+  this->signB_.assign(s, 1);
+  this->b_ = 0;
+
+  mpz_class aq;
+  for (uint32_t j = 0; j < s; ++j) {
+    const uint32_t index = this->aFactors_[j];
+    const uint32_t q = this->factorBase_[index];
+    this->isFactorA_[index] = true;
+
+    mpz_divexact_ui(aq.get_mpz_t(), this->a_.get_mpz_t(), q);
+    const uint64_t inverse = MathFunctions::inverse_mod(mpz_fdiv_ui(aq.get_mpz_t(), q), q);
+
+    uint64_t gamma = this->sqrtN_[index] * inverse % q;
+    if (gamma > q / 2)
+      gamma = q - gamma;
+
+    mpz_mul_ui(this->B_[j].get_mpz_t(), aq.get_mpz_t(), gamma);
+    this->b_ += this->B_[j];
+  }
+
+  std::vector<uint32_t> inverses;
+  MathFunctions::inverse_mod(this->a_, this->factorBase_, inverses);
+
+  this->Bainv2_.assign(s, std::vector<uint32_t>(this->factorBase_.size(), 0));
+  this->firstRoots_.assign(this->factorBase_.size(), 0);
+  this->secondRoots_.assign(this->factorBase_.size(), 0);
+
+  for (uint32_t k = 0; k < this->factorBase_.size(); ++k) {
+    if (this->isFactorA_[k])
+      continue;
+
+    const uint64_t p = this->factorBase_[k];
+    const uint64_t ainv = inverses[k];
+
+    for (uint32_t j = 0; j < s; ++j) {
+      this->Bainv2_[j][k] = static_cast<uint32_t>(2 * mpz_fdiv_ui(this->B_[j].get_mpz_t(), p) * ainv % p);
+    }
+
+    const uint64_t bModP = mpz_fdiv_ui(this->b_.get_mpz_t(), p);
+    const uint64_t t = this->sqrtN_[k];
+    const uint64_t shift = M % p;
+
+    const uint64_t firstRoot = ainv * ((t + p - bModP) % p) % p;
+    const uint64_t secondRoot = ainv * ((2 * p - t - bModP) % p) % p;
+
+    this->firstRoots_[k] = static_cast<uint32_t>((firstRoot + shift) % p);
+    this->secondRoots_[k] = static_cast<uint32_t>((secondRoot + shift) % p);
+  }
+}
+
+/**
+ * Switch to next b with the same a:
+ *     b_(i+1) = b_i + 2 * (-1)^e * B_v, where 2^v || 2i (Gray code)
+ */
+void SelfInitializingSieve::nextPolynomial(uint32_t index) {
+  uint32_t v = 0;
+  while ((index & 1) == 0) {
+    index >>= 1;
+    ++v;
+  }
+
+  this->signB_[v] = -this->signB_[v];
+  const bool add = this->signB_[v] > 0;
+
+  if (add) {
+    this->b_ += 2 * this->B_[v];
+  } else {
+    this->b_ -= 2 * this->B_[v];
+  }
+
+  const auto &delta = this->Bainv2_[v];
+  for (uint32_t k = 0; k < this->factorBase_.size(); ++k) {
+    if (this->isFactorA_[k])
+      continue;
+
+    const uint32_t p = this->factorBase_[k];
+    if (add) {
+      this->firstRoots_[k] = (this->firstRoots_[k] + p - delta[k]) % p;
+      this->secondRoots_[k] = (this->secondRoots_[k] + p - delta[k]) % p;
+    } else {
+      this->firstRoots_[k] = (this->firstRoots_[k] + delta[k]) % p;
+      this->secondRoots_[k] = (this->secondRoots_[k] + delta[k]) % p;
+    }
+  }
+}
+
+/**
+ * Put hits of primes, which are larger then block, to bucket of their block.
+ * Such prime hits every block at most once, so it is cheaper to sort its hits once,
+ * then to check it for every block.
+ */
+void SelfInitializingSieve::fillBuckets(uint32_t interval) {
+  const uint32_t blocks = ((interval - 1) >> this->blockBits_) + 1;
+  this->buckets_.resize(blocks);
+  for (auto &bucket: this->buckets_)
+    bucket.clear();
+
+  for (uint32_t k = this->largeSieveIndex_; k < this->factorBase_.size(); ++k) {
+    if (this->isFactorA_[k])
+      continue;
+
+    const uint32_t p = this->factorBase_[k];
+    const uint32_t first = this->firstRoots_[k];
+    const uint32_t second = this->secondRoots_[k];
+
+    for (const uint32_t root: {first, second}) {
+      for (uint32_t i = root; i < interval; i += p) {
+        this->buckets_[i >> this->blockBits_].push_back(BucketHit{i, k});
+      }
+
+      if (first == second)
+        break;
+    }
+  }
+}
+
+/**
+ * Interval is sieved block by block, so every block stays in L1 cache:
+ * small primes are sieved over block, then hits of large primes are taken from its bucket.
+ */
+void SelfInitializingSieve::sieveNumbersForInterval(std::vector<uint8_t> &sieve) {
+  const auto interval = static_cast<uint32_t>(sieve.size());
+  const uint32_t blockSize = 1u << this->blockBits_;
+  const uint8_t initial = SieveScanner::initial_value(this->logEstimate_ - this->threshold_);
+
+  this->fillBuckets(interval);
+
+  // Next hits of small primes
+  std::vector<uint32_t> first(this->firstRoots_.begin(), this->firstRoots_.begin() + this->largeSieveIndex_);
+  std::vector<uint32_t> second(this->secondRoots_.begin(), this->secondRoots_.begin() + this->largeSieveIndex_);
+
+  for (uint32_t start = 0; start < interval; start += blockSize) {
+    const uint32_t end = std::min(start + blockSize, interval);
+    std::fill(sieve.begin() + start, sieve.begin() + end, initial);
+
+    for (uint32_t k = this->startSieveIndex_; k < this->largeSieveIndex_; ++k) {
+      if (this->isFactorA_[k])
+        continue;
+
+      const uint32_t p = this->factorBase_[k];
+      const uint8_t logp = this->sieveLogs_[k];
+      const bool twoRoots = first[k] != second[k];
+
+      uint32_t i = first[k];
+      for (; i < end; i += p) {
+        sieve[i] += logp;
+      }
+      first[k] = i;
+
+      if (!twoRoots) {
+        second[k] = i;
+        continue;
+      }
+
+      for (i = second[k]; i < end; i += p) {
+        sieve[i] += logp;
+      }
+      second[k] = i;
+    }
+
+    for (const auto &hit: this->buckets_[start >> this->blockBits_]) {
+      sieve[hit.position] += this->sieveLogs_[hit.index];
+    }
+  }
+}
+
+/**
+ * Find sieved primes, which divide Q(x) of every candidate.
+ * Small primes are checked for every candidate, or walk over interval again
+ * and stop only on candidates, if it is cheaper. Hits of large primes are already in buckets.
+ */
+void SelfInitializingSieve::resieveCandidates(const std::vector<uint8_t> &sieve,
+                                              const std::vector<uint32_t> &positions,
+                                              std::vector<std::vector<uint32_t> > &hits) const {
+  const auto interval = static_cast<uint32_t>(sieve.size());
+  hits.assign(positions.size(), std::vector<uint32_t>());
+
+  for (uint32_t k = this->startSieveIndex_; k < this->largeSieveIndex_; ++k) {
+    if (this->isFactorA_[k])
+      continue;
+
+    const uint32_t p = this->factorBase_[k];
+    const uint32_t first = this->firstRoots_[k];
+    const uint32_t second = this->secondRoots_[k];
+
+    if (static_cast<uint64_t>(p) * positions.size() <= interval) {
+      for (uint32_t c = 0; c < positions.size(); ++c) {
+        const uint32_t r = positions[c] % p;
+        if (r == first || r == second)
+          hits[c].emplace_back(k);
+      }
+      continue;
+    }
+
+    for (const uint32_t root: {first, second}) {
+      for (uint32_t i = root; i < interval; i += p) {
+        if ((sieve[i] & SieveScanner::candidateMark) == 0)
+          continue;
+
+        const auto c = std::lower_bound(positions.begin(), positions.end(), i) - positions.begin();
+        hits[c].emplace_back(k);
+      }
+
+      if (first == second)
+        break;
+    }
+  }
+
+  for (const auto &bucket: this->buckets_) {
+    for (const auto &hit: bucket) {
+      if ((sieve[hit.position] & SieveScanner::candidateMark) == 0)
+        continue;
+
+      const auto c = std::lower_bound(positions.begin(), positions.end(), hit.position) - positions.begin();
+      hits[c].emplace_back(hit.index);
+    }
+  }
+}
+
+void SelfInitializingSieve::getNumbersBelowThreshold(const std::vector<uint8_t> &sieve,
+                                                     std::vector<Relation> &relations,
+                                                     std::vector<PartialRelation> &partials) const {
+  const auto M = static_cast<int32_t>(this->parameters_.halfInterval);
+
+  std::vector<uint32_t> positions;
+  SieveScanner::find_candidates(sieve, positions);
+
+  std::vector<std::vector<uint32_t> > hits;
+  this->resieveCandidates(sieve, positions, hits);
+
+  Relation relation;
+  for (uint32_t c = 0; c < positions.size(); ++c) {
+    const mpz_class cofactor = this->factorSmallNumber(static_cast<int32_t>(positions[c]) - M, hits[c], relation);
+
+    if (cofactor == 1) {
+      relations.emplace_back(std::move(relation));
+    } else {
+      this->addPartialRelation(relation, cofactor, partials);
+    }
+  }
+}
+
+/**
+ * Keep relation, if cofactor is large prime or product of two large primes.
+ * Odd prime p divides Q(x) only if kN is quadratic residue mod p or p | kN. Primes of both kinds
+ * up to max prime are in factor base, and they were divided out.
+ * So cofactor less then largePrimeBound_ <= (max prime)^2 is prime.
+ */
+void SelfInitializingSieve::addPartialRelation(Relation &relation, const mpz_class &cofactor,
+                                               std::vector<PartialRelation> &partials) const {
+  if (mpz_sizeinbase(cofactor.get_mpz_t(), 2) > 64)
+    return;
+
+  const uint64_t value = toUint64(cofactor);
+  const uint64_t bound = this->largePrimeBound_;
+
+  if (value < bound) {
+    partials.push_back(PartialRelation{std::move(relation), value, 1});
+    return;
+  }
+
+  if (this->parameters_.largePrimes < 2 || value / bound >= bound)
+    return;
+
+  if (NativeFactorizer::is_prime(value))
+    return;
+
+  const uint64_t divider = NativeFactorizer::pollard_brent(value);
+  if (divider == value || divider >= bound || value / divider >= bound)
+    return;
+
+  partials.push_back(PartialRelation{std::move(relation), divider, value / divider});
+}
+
+/**
+ * Division of Q(x) = ((a * x + b)^2 - N) / a by primes of factor base, which divide it.
+ * Sieved primes are known from resieving, only primes less then minSievePrime
+ * and factors of 'a' are checked by trial division.
+ * Factors of 'a' are added to relation, because Y^2 - N = a * Q(x).
+ */
+mpz_class SelfInitializingSieve::factorSmallNumber(const int32_t &x, const std::vector<uint32_t> &hits,
+                                                   Relation &relation) const {
+  relation.y = this->a_ * static_cast<long>(x) + this->b_;
+
+  mpz_class Q = relation.y * relation.y - this->n_;
+  mpz_divexact(Q.get_mpz_t(), Q.get_mpz_t(), this->a_.get_mpz_t());
+
+  relation.negative = mpz_sgn(Q.get_mpz_t()) < 0;
+  relation.largeFactor = 1;
+  mpz_abs(Q.get_mpz_t(), Q.get_mpz_t());
+
+  relation.factors = this->aFactors_;
+
+  const auto divide = [&](uint32_t k) {
+    const uint32_t &p = this->factorBase_[k];
+    while (mpz_divisible_ui_p(Q.get_mpz_t(), p)) {
+      mpz_divexact_ui(Q.get_mpz_t(), Q.get_mpz_t(), p);
+      relation.factors.emplace_back(k);
+    }
+  };
+
+  for (uint32_t k = 0; k < this->startSieveIndex_; ++k)
+    divide(k);
+
+  for (const auto &k: this->aFactors_)
+    divide(k);
+
+  for (const auto &k: hits)
+    divide(k);
+
+  return Q;
+}
+
+void SelfInitializingSieve::setWorker(uint32_t index, uint32_t count) {
+  this->worker_ = index;
+  this->workers_ = count;
+}
+
+// Sets of factors of 'a' are split between workers by sum of their indices
+bool SelfInitializingSieve::ownsA(const std::vector<uint32_t> &key) const {
+  uint64_t sum = 0;
+  for (const auto &index: key)
+    sum += index;
+
+  return sum % this->workers_ == this->worker_;
+}
+
+void SelfInitializingSieve::sievePolynomial(std::vector<Relation> &relations, std::vector<PartialRelation> &partials) {
+  if (this->polynomialIndex_ == this->polynomials_) {
+    this->generatePolynomialA();
+    this->initializePolynomial();
+
+    this->polynomials_ = 1u << (this->aFactors_.size() - 1);
+    this->polynomialIndex_ = 0;
+  } else if (this->polynomialIndex_ > 0) {
+    this->nextPolynomial(this->polynomialIndex_);
+  }
+
+  this->sieve_.resize(2 * this->parameters_.halfInterval);
+  this->sieveNumbersForInterval(this->sieve_);
+  this->getNumbersBelowThreshold(this->sieve_, relations, partials);
+  ++this->polynomialIndex_;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file SelfInitializingSieve.h
+ * Self-initializing quadratic sieve (SIQS).
+ * Many polynomials Q(x) = ((a * x + b)^2 - N) / a are sieved over a short
+ * interval [-M, M), switching between polynomials with the same 'a' with help of Gray code.
+ * Description:
+ * https://en.wikipedia.org/wiki/Quadratic_sieve#Multiple_polynomials
+ * http://www.crypto-world.com/documents/contini_siqs.pdf
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 02.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_SELFINITIALIZINGSIEVE_H
+#define OOP_4_AND_5_SELFINITIALIZINGSIEVE_H
+
+#include <set>
+#include <vector>
+#include <random>
+#include <gmpxx.h>
+#include <gmp.h>
+
+#include <Relation/Relation.h>
+#include <ParameterTable/ParameterTable.h>
+
+class SelfInitializingSieve final {
+
+ public:
+  using Parameters = ParameterTable::Parameters;
+
+  // n is number, which is sieved (kN), parameters are taken for N itself.
+  // Interval is sieved by blocks of blockSize bytes (0 means size of L1 cache)
+  SelfInitializingSieve(const mpz_class &n, const std::vector<uint32_t> &factorBase,
+                        const Parameters &parameters, uint32_t blockSize = 0);
+  SelfInitializingSieve(const SelfInitializingSieve &) = delete;
+  SelfInitializingSieve &operator=(const SelfInitializingSieve &) = delete;
+
+  // Sieves with different index of the same count never use the same polynomial,
+  // so they can collect relations for one N in parallel
+  void setWorker(uint32_t index, uint32_t count);
+
+  // Sieve next polynomial: full relations are appended to relations, relations with large primes to partials.
+  // If there is no new polynomial for factor base, std::invalid_argument is thrown
+  void sievePolynomial(std::vector<Relation> &relations, std::vector<PartialRelation> &partials);
+
+  // Parameters of N from process-wide table, rows are keyed by digits of N, not kN
+  static Parameters getParameters(const mpz_class &n);
+
+ private:
+  // Hit of large prime with index 'index' of factor base at position of interval
+  struct BucketHit {
+    uint32_t position;
+    uint32_t index;
+  };
+
+  void solveShanksEquation();
+  void aproxFactorBase();
+
+  bool ownsA(const std::vector<uint32_t> &key) const;
+  void generatePolynomialA();
+  void initializePolynomial();
+  void nextPolynomial(uint32_t index);
+
+  void fillBuckets(uint32_t interval);
+  void sieveNumbersForInterval(std::vector<uint8_t> &sieve);
+
+  void getNumbersBelowThreshold(const std::vector<uint8_t> &sieve, std::vector<Relation> &relations,
+                                std::vector<PartialRelation> &partials) const;
+
+  // hits[c] are indices of sieved primes, which divide Q(x) of candidate with position positions[c]
+  void resieveCandidates(const std::vector<uint8_t> &sieve, const std::vector<uint32_t> &positions,
+                         std::vector<std::vector<uint32_t> > &hits) const;
+
+  mpz_class factorSmallNumber(const int32_t &x, const std::vector<uint32_t> &hits, Relation &relation) const;
+
+  void addPartialRelation(Relation &relation, const mpz_class &cofactor, std::vector<PartialRelation> &partials) const;
+
+  const mpz_class n_;
+  const std::vector<uint32_t> factorBase_;
+  const Parameters parameters_;
+
+  // sqrt(N) mod p for every prime of factor base
+  std::vector<uint32_t> sqrtN_;
+  std::vector<double> logFactorBase_;
+
+  // Rounded logs, which are added to byte sieve array
+  std::vector<uint8_t> sieveLogs_;
+
+  // Primes less then it aren't sieved
+  uint32_t startSieveIndex_;
+
+  // Primes from it aren't less then block, so they are sieved through buckets
+  uint32_t largeSieveIndex_;
+  uint32_t blockBits_;
+  std::vector<std::vector<BucketHit> > buckets_;
+
+  double logEstimate_;
+  double threshold_;
+  uint64_t largePrimeBound_;
+
+  // Polynomial coefficients: a = q_1 * ... * q_s, b = +-B_1 +- ... +- B_s
+  mpz_class a_;
+  mpz_class b_;
+  std::vector<uint32_t> aFactors_;
+  std::vector<char> isFactorA_;
+  std::vector<mpz_class> B_;
+  std::vector<int> signB_;
+
+  // Count of polynomials with current 'a' and index of next of them
+  uint32_t polynomials_;
+  uint32_t polynomialIndex_;
+
+  // 2 * B_j * a^(-1) mod p for every j and every prime of factor base
+  std::vector<std::vector<uint32_t> > Bainv2_;
+
+  // Roots of Q(x) = 0 mod p, shifted on M
+  std::vector<uint32_t> firstRoots_;
+  std::vector<uint32_t> secondRoots_;
+
+  // Index of this sieve between all sieves for N
+  uint32_t worker_;
+  uint32_t workers_;
+
+  std::vector<uint8_t> sieve_;
+
+  std::set<std::vector<uint32_t> > usedA_;
+  std::mt19937 random_;
+};
+
+#endif //OOP_4_AND_5_SELFINITIALIZINGSIEVE_H
@@ -0,0 +1,134 @@
+/**
+ * @file SieveEngine.cpp
+ * Interface of algorithms, which find all primes of range [low, high].
+ * @href https://en.wikipedia.org/wiki/Sieve_of_Atkin
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <SieveEngine/SieveEngine.h>
+#include <BucketSieve/BucketSieve.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+  // Atkin keeps byte for every number up to high, so it's used only for small ranges from 0
+  const uint64_t atkinMaxHigh = 1ull << 16;
+
+  // Buckets pay off, when most of sieving primes are larger then block
+  const uint64_t bucketMinHigh = 1ull << 22;
+
+  class AtkinEngine final : public SieveEngine {
+   public:
+    const char *name() const override { return "Atkin"; }
+    void sieve(uint64_t low, uint64_t high, std::vector<uint64_t> &primes) const override;
+
+   private:
+    // Residues modulo 60 for every quadratic form from description of algorithm
+    static const bool firstForm_[60];
+    static const bool secondForm_[60];
+    static const bool thirdForm_[60];
+  };
+
+  const bool AtkinEngine::firstForm_[60] = {
+      0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+      0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0};
+  const bool AtkinEngine::secondForm_[60] = {
+      0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+  const bool AtkinEngine::thirdForm_[60] = {
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+
+  void AtkinEngine::sieve(uint64_t low, uint64_t high, std::vector<uint64_t> &primes) const {
+    std::vector<uint8_t> isPrime(high + 1, 0);
+
+    // Candidates have odd number of representations by quadratic forms
+    for (uint64_t x = 1; 4 * x * x <= high; ++x) {
+      for (uint64_t y = 1, n = 4 * x * x + 1; n <= high; y += 2, n = 4 * x * x + y * y) {
+        if (firstForm_[n % 60])
+          isPrime[n] ^= 1;
+      }
+    }
+
+    for (uint64_t x = 1; 3 * x * x <= high; x += 2) {
+      for (uint64_t y = 2, n = 3 * x * x + 4; n <= high; y += 2, n = 3 * x * x + y * y) {
+        if (secondForm_[n % 60])
+          isPrime[n] ^= 1;
+      }
+    }
+
+    for (uint64_t x = 2; 2 * x * x + 2 * x - 1 <= high; ++x) {
+      for (uint64_t y = x - 1, n = 2 * x * x + 2 * x - 1; y >= 1 && n <= high; --y, n = 3 * x * x - y * y) {
+        if (thirdForm_[n % 60])
+          isPrime[n] ^= 1;
+      }
+    }
+
+    // Candidates are square-free, so multiples of squares of primes are removed
+    for (uint64_t r = 7; r * r <= high; ++r) {
+      if (isPrime[r]) {
+        for (uint64_t n = r * r; n <= high; n += r * r)
+          isPrime[n] = 0;
+      }
+    }
+
+    for (const uint64_t p: {2, 3, 5}) {
+      if (p >= low && p <= high)
+        primes.emplace_back(p);
+    }
+
+    for (uint64_t n = std::max<uint64_t>(low, 7); n <= high; ++n) {
+      if (isPrime[n])
+        primes.emplace_back(n);
+    }
+  }
+
+  template<typename Sieve>
+  class SegmentedEngine final : public SieveEngine {
+   public:
+    explicit SegmentedEngine(const char *name) : name_(name) {}
+
+    const char *name() const override { return this->name_; }
+
+    void sieve(uint64_t low, uint64_t high, std::vector<uint64_t> &primes) const override {
+      Sieve sieve(low, high);
+      std::vector<uint64_t> block;
+
+      while (sieve.next(block)) {
+        primes.insert(primes.end(), block.begin(), block.end());
+      }
+    }
+
+   private:
+    const char *name_;
+  };
+
+}
+
+std::unique_ptr<SieveEngine> SieveEngine::create(Kind kind) {
+  switch (kind) {
+    case Kind::Atkin:
+      return std::unique_ptr<SieveEngine>(new AtkinEngine());
+    case Kind::Eratosthenes:
+      return std::unique_ptr<SieveEngine>(new SegmentedEngine<SegmentedSieve>("Eratosthenes"));
+    case Kind::Bucket:
+      return std::unique_ptr<SieveEngine>(new SegmentedEngine<BucketSieve>("Bucket"));
+  }
+
+  throw std::invalid_argument("Unknown sieve engine");
+}
+
+SieveEngine::Kind SieveEngine::select(uint64_t low, uint64_t high) {
+  if (low == 0 && high <= atkinMaxHigh)
+    return Kind::Atkin;
+
+  if (high >= bucketMinHigh)
+    return Kind::Bucket;
+
+  return Kind::Eratosthenes;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file SieveEngine.h
+ * Interface of algorithms, which find all primes of range [low, high].
+ * Engines:
+ *     - Atkin: sieve of Atkin over [0, high] with lookup tables of residues modulo 60;
+ *     - Eratosthenes: segmented sieve over odd numbers (see SegmentedSieve);
+ *     - Bucket: segmented sieve with buckets for large primes (see BucketSieve).
+ * select() chooses the fastest one for range, see SieveBenchmark for comparison.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_SIEVEENGINE_H
+#define OOP_4_AND_5_SIEVEENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class SieveEngine {
+
+ public:
+  enum class Kind {
+    Atkin,
+    Eratosthenes,
+    Bucket
+  };
+
+  virtual ~SieveEngine() = default;
+
+  virtual const char *name() const = 0;
+
+  // Append primes from [low, high] in ascending order
+  virtual void sieve(uint64_t low, uint64_t high, std::vector<uint64_t> &primes) const = 0;
+
+  static std::unique_ptr<SieveEngine> create(Kind kind);
+
+  // The fastest engine for range
+  static Kind select(uint64_t low, uint64_t high);
+};
+
+#endif //OOP_4_AND_5_SIEVEENGINE_H
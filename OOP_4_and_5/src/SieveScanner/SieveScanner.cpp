@@ -0,0 +1,89 @@
+/**
+ * @file SieveScanner.cpp
+ * Byte sieve array of quadratic sieve.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 16.12.2017
+ * @version 1.0
+ */
+#include <SieveScanner/SieveScanner.h>
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+  const uint64_t highBits = 0x8080808080808080ull;
+
+  const uint32_t defaultCacheSize = 32 * 1024;
+  const uint32_t minBlockSize = 4 * 1024;
+  const uint32_t maxBlockSize = 1024 * 1024;
+
+  // Check bytes one by one, only if block has some candidates
+  inline void scanBlock(const uint8_t *data, uint32_t start, uint32_t size, std::vector<uint32_t> &positions) {
+    for (uint32_t i = start; i < start + size; ++i) {
+      if (data[i] & SieveScanner::candidateMark)
+        positions.emplace_back(i);
+    }
+  }
+
+}
+
+uint8_t SieveScanner::scaled_log(double x) {
+  return static_cast<uint8_t>(std::lround(std::log2(x)));
+}
+
+uint8_t SieveScanner::initial_value(double required) {
+  const long value = candidateMark - std::lround(required);
+  return static_cast<uint8_t>(value < 0 ? 0 : value);
+}
+
+uint32_t SieveScanner::default_block_size() {
+  long size = 0;
+
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+  size = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+#endif
+
+  if (size < minBlockSize || size > maxBlockSize)
+    return defaultCacheSize;
+
+  return static_cast<uint32_t>(size);
+}
+
+void SieveScanner::find_candidates(const std::vector<uint8_t> &sieve, std::vector<uint32_t> &positions) {
+  const uint8_t *data = sieve.data();
+  const auto size = static_cast<uint32_t>(sieve.size());
+  uint32_t i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 32 <= size; i += 32) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    if (_mm256_movemask_epi8(block) != 0)
+      scanBlock(data, i, 32, positions);
+  }
+#elif defined(__SSE2__)
+  for (; i + 16 <= size; i += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    if (_mm_movemask_epi8(block) != 0)
+      scanBlock(data, i, 16, positions);
+  }
+#endif
+
+  for (; i + 8 <= size; i += 8) {
+    uint64_t block;
+    std::memcpy(&block, data + i, sizeof(block));
+    if ((block & highBits) != 0)
+      scanBlock(data, i, 8, positions);
+  }
+
+  scanBlock(data, i, size - i, positions);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file SieveScanner.h
+ * Byte sieve array of quadratic sieve.
+ * Every byte starts from (candidateMark - allowed deficit of logs), logs of primes are added to it,
+ * so numbers, which got enough logs, have high bit set. Array is scanned
+ * for such bytes by 32 (AVX2), 16 (SSE2) or 8 bytes at a time.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 16.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_SIEVESCANNER_H
+#define OOP_4_AND_5_SIEVESCANNER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace SieveScanner {
+
+  // Byte is candidate, if this bit is set
+  const uint8_t candidateMark = 0x80;
+
+  // log2(x) rounded to byte
+  uint8_t scaled_log(double x);
+
+  // Initial byte, when logs of primes must sum up to at least 'required'
+  uint8_t initial_value(double required);
+
+  // Size of L1 data cache, or 32 KiB, if it is unknown
+  uint32_t default_block_size();
+
+  // Append positions of bytes with high bit in ascending order
+  void find_candidates(const std::vector<uint8_t> &sieve, std::vector<uint32_t> &positions);
+
+}
+
+#endif //OOP_4_AND_5_SIEVESCANNER_H
@@ -0,0 +1,117 @@
+/**
+ * @file SparseMatrix.cpp
+ * Sparse matrix over GF(2) in compressed sparse column (CSC) form.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#include <SparseMatrix/SparseMatrix.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+  // Blocks smaller then it aren't split between threads
+  const size_t minParallelSize = 4096;
+
+}
+
+SparseMatrix::SparseMatrix(uint32_t rows, uint32_t threads) : rows_(rows), threads_(threads), colStart_(1, 0) {
+  if (this->threads_ == 0) {
+    this->threads_ = std::max(1u, std::thread::hardware_concurrency());
+  }
+  this->pool_.reset(new ThreadPool(this->threads_));
+}
+
+void SparseMatrix::addColumn(std::vector<uint32_t> rows) {
+  std::sort(rows.begin(), rows.end());
+
+  for (size_t i = 0; i < rows.size();) {
+    size_t j = i;
+    while (j < rows.size() && rows[j] == rows[i])
+      ++j;
+
+    if ((j - i) % 2 == 1)
+      this->rowIndex_.emplace_back(rows[i]);
+
+    i = j;
+  }
+
+  this->colStart_.emplace_back(static_cast<uint32_t>(this->rowIndex_.size()));
+}
+
+uint32_t SparseMatrix::rows() const {
+  return this->rows_;
+}
+
+uint32_t SparseMatrix::cols() const {
+  return static_cast<uint32_t>(this->colStart_.size() - 1);
+}
+
+uint32_t SparseMatrix::threads() const {
+  return this->threads_;
+}
+
+void SparseMatrix::parallelFor(size_t size, const std::function<void(size_t, size_t, uint32_t)> &f) const {
+  const auto count = static_cast<uint32_t>(std::min<size_t>(this->threads_, size / minParallelSize + 1));
+
+  if (count <= 1) {
+    f(0, size, 0);
+    return;
+  }
+
+  const size_t part = (size + count - 1) / count;
+
+  this->pool_->run(count, [&](uint32_t t) {
+    const size_t begin = std::min(size, t * part);
+    const size_t end = std::min(size, begin + part);
+    f(begin, end, t);
+  });
+}
+
+void SparseMatrix::multiply(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const {
+  const uint32_t cols = this->cols();
+  const auto count = static_cast<uint32_t>(std::min<size_t>(this->threads_, cols / minParallelSize + 1));
+
+  // Every thread writes to own copy of result, then they are summed
+  std::vector<std::vector<uint64_t> > partial(count, std::vector<uint64_t>(this->rows_, 0));
+
+  this->parallelFor(cols, [&](size_t begin, size_t end, uint32_t thread) {
+    auto &result = partial[thread];
+    for (size_t j = begin; j < end; ++j) {
+      const uint64_t value = x[j];
+      for (uint32_t k = this->colStart_[j]; k < this->colStart_[j + 1]; ++k) {
+        result[this->rowIndex_[k]] ^= value;
+      }
+    }
+  });
+
+  y.swap(partial[0]);
+  for (uint32_t t = 1; t < count; ++t) {
+    for (uint32_t i = 0; i < this->rows_; ++i) {
+      y[i] ^= partial[t][i];
+    }
+  }
+}
+
+void SparseMatrix::multiplyTransposed(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const {
+  y.assign(this->cols(), 0);
+
+  this->parallelFor(this->cols(), [&](size_t begin, size_t end, uint32_t) {
+    for (size_t j = begin; j < end; ++j) {
+      uint64_t value = 0;
+      for (uint32_t k = this->colStart_[j]; k < this->colStart_[j + 1]; ++k) {
+        value ^= x[this->rowIndex_[k]];
+      }
+      y[j] = value;
+    }
+  });
+}
+
+void SparseMatrix::multiplySymmetric(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const {
+  std::vector<uint64_t> temp;
+  this->multiply(x, temp);
+  this->multiplyTransposed(temp, y);
+}
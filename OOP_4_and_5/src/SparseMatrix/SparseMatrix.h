@@ -0,0 +1,58 @@
+/**
+ * @file SparseMatrix.h
+ * Sparse matrix over GF(2) in compressed sparse column (CSC) form.
+ * Multiplication by block of 64 vectors is split between threads of one pool,
+ * which lives as long as matrix.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_SPARSEMATRIX_H
+#define OOP_4_AND_5_SPARSEMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <ThreadPool/ThreadPool.h>
+
+class SparseMatrix final {
+
+ public:
+  explicit SparseMatrix(uint32_t rows, uint32_t threads = 0);
+
+  // Add column with ones in given rows. Rows, which appear even times, are skipped.
+  void addColumn(std::vector<uint32_t> rows);
+
+  uint32_t rows() const;
+  uint32_t cols() const;
+
+  // y = M * x, where x is cols() x 64 and y is rows() x 64 block of vectors
+  void multiply(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const;
+
+  // y = M^T * x, where x is rows() x 64 and y is cols() x 64 block of vectors
+  void multiplyTransposed(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const;
+
+  // y = M^T * M * x
+  void multiplySymmetric(const std::vector<uint64_t> &x, std::vector<uint64_t> &y) const;
+
+  // Run f(begin, end, thread) on parts of [0, size) in different threads
+  void parallelFor(size_t size, const std::function<void(size_t, size_t, uint32_t)> &f) const;
+
+  uint32_t threads() const;
+
+ private:
+  uint32_t rows_;
+  uint32_t threads_;
+
+  // Column j has ones in rows rowIndex_[colStart_[j]] ... rowIndex_[colStart_[j + 1] - 1]
+  std::vector<uint32_t> colStart_;
+  std::vector<uint32_t> rowIndex_;
+
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+#endif //OOP_4_AND_5_SPARSEMATRIX_H
@@ -0,0 +1,112 @@
+/**
+ * @file ThreadPool.cpp
+ * Fixed set of threads, which run one parallel task after another.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#include <ThreadPool/ThreadPool.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+ThreadPool::ThreadPool(uint32_t threads)
+    : threads_(std::max(1u, threads)), task_(nullptr), taskCount_(0), generation_(0), pending_(0),
+      stopping_(false) {}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lg(this->mutex_);
+    this->stopping_ = true;
+  }
+  this->wake_.notify_all();
+
+  for (auto &worker: this->workers_) {
+    worker.join();
+  }
+}
+
+uint32_t ThreadPool::threads() const {
+  return this->threads_;
+}
+
+void ThreadPool::run(uint32_t count, const std::function<void(uint32_t)> &f) {
+  if (count > this->threads_) {
+    throw std::invalid_argument("Task has more parts then threads in pool.");
+  }
+
+  if (count <= 1) {
+    f(0);
+    return;
+  }
+
+  // Thread 0 is the calling one
+  for (auto index = static_cast<uint32_t>(this->workers_.size()) + 1; index < this->threads_; ++index) {
+    this->workers_.emplace_back(&ThreadPool::work, this, index);
+  }
+
+  {
+    std::lock_guard<std::mutex> lg(this->mutex_);
+    this->task_ = &f;
+    this->taskCount_ = count;
+    this->pending_ = count - 1;
+    this->error_ = nullptr;
+    ++this->generation_;
+  }
+  this->wake_.notify_all();
+
+  std::exception_ptr error;
+  try {
+    f(0);
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  std::unique_lock<std::mutex> ul(this->mutex_);
+  this->done_.wait(ul, [this] { return this->pending_ == 0; });
+  this->task_ = nullptr;
+
+  if (!error) {
+    error = this->error_;
+  }
+  this->error_ = nullptr;
+  ul.unlock();
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void ThreadPool::work(uint32_t index) {
+  uint64_t generation = 0;
+  std::unique_lock<std::mutex> ul(this->mutex_);
+
+  for (;;) {
+    this->wake_.wait(ul, [this, generation] { return this->stopping_ || this->generation_ != generation; });
+    if (this->stopping_)
+      return;
+
+    generation = this->generation_;
+    if (index >= this->taskCount_)
+      continue;
+
+    const auto &task = *this->task_;
+    ul.unlock();
+
+    std::exception_ptr error;
+    try {
+      task(index);
+    } catch (...) {
+      error = std::current_exception();
+    }
+
+    ul.lock();
+    if (error && !this->error_) {
+      this->error_ = error;
+    }
+    if (--this->pending_ == 0) {
+      this->done_.notify_one();
+    }
+  }
+}
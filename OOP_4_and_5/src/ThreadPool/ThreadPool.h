@@ -0,0 +1,56 @@
+/**
+ * @file ThreadPool.h
+ * Fixed set of threads, which run one parallel task after another.
+ * Threads are started on first task and live until pool is destroyed,
+ * so short tasks (multiplications inside Lanczos loop) don't pay for thread creation.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_THREADPOOL_H
+#define OOP_4_AND_5_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool final {
+
+ public:
+  explicit ThreadPool(uint32_t threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Run f(0), ..., f(count - 1) in parallel and wait for all of them, count must not be more then threads().
+  // f(0) is run in calling thread. Exception of any part is thrown again from run().
+  // Only one thread can run tasks at the same time.
+  void run(uint32_t count, const std::function<void(uint32_t)> &f);
+
+  uint32_t threads() const;
+
+ private:
+  void work(uint32_t index);
+
+  uint32_t threads_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+
+  // Current task, workers with index less then taskCount_ take part in it
+  const std::function<void(uint32_t)> *task_;
+  uint32_t taskCount_;
+  uint64_t generation_;
+  uint32_t pending_;
+  std::exception_ptr error_;
+  bool stopping_;
+};
+
+#endif //OOP_4_AND_5_THREADPOOL_H
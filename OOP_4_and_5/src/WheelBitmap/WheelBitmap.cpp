@@ -0,0 +1,66 @@
+/**
+ * @file WheelBitmap.cpp
+ * Set of primes from range [low, high] on mod-30 wheel.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#include <WheelBitmap/WheelBitmap.h>
+
+const int8_t WheelBitmap::wheelIndex_[30] = {-1, 0, -1, -1, -1, -1, -1, 1, -1, -1,
+                                             -1, 2, -1, 3, -1, -1, -1, 4, -1, 5,
+                                             -1, -1, -1, 6, -1, -1, -1, -1, -1, 7};
+
+const uint8_t WheelBitmap::wheelOffsets_[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+
+void WheelBitmap::reset(long long low, long long high) {
+  this->base_ = low - low % 30;
+  this->bits_.assign(static_cast<size_t>((high - this->base_) / 30 + 1), 0);
+  this->mapped_ = false;
+  this->data_ = this->bits_.data();
+  this->bytes_ = this->bits_.size();
+}
+
+void WheelBitmap::extend(long long high) {
+  if (this->mapped_) {
+    this->bits_.assign(this->data_, this->data_ + this->bytes_);
+    this->mapped_ = false;
+  }
+
+  this->bits_.resize(static_cast<size_t>((high - this->base_) / 30 + 1), 0);
+  this->data_ = this->bits_.data();
+  this->bytes_ = this->bits_.size();
+}
+
+void WheelBitmap::set(long long n) {
+  const int8_t index = wheelIndex_[n % 30];
+
+  // 2, 3 and 5 are known without bitmap
+  if (index >= 0)
+    this->bits_[(n - this->base_) / 30] |= static_cast<uint8_t>(1u << index);
+}
+
+bool WheelBitmap::test(long long n) const {
+  const int8_t index = wheelIndex_[n % 30];
+  if (index < 0)
+    return n == 2 || n == 3 || n == 5;
+
+  return ((this->data_[(n - this->base_) / 30] >> index) & 1) != 0;
+}
+
+void WheelBitmap::map(const uint8_t *bits, size_t bytes) {
+  this->base_ = 0;
+  std::vector<uint8_t>().swap(this->bits_);
+  this->data_ = bits;
+  this->bytes_ = bytes;
+  this->mapped_ = true;
+}
+
+const uint8_t *WheelBitmap::bits() const {
+  return this->data_;
+}
+
+size_t WheelBitmap::bytes() const {
+  return this->bytes_;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file WheelBitmap.h
+ * Set of primes from range [low, high] on mod-30 wheel.
+ * Only 8 residues modulo 30 are coprime with 30, so one byte keeps 30 numbers.
+ * Bitmap can be view of mapped cache file, then it's copied only when it's extended.
+ * @href https://en.wikipedia.org/wiki/Wheel_factorization
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#ifndef OOP_4_AND_5_WHEELBITMAP_H
+#define OOP_4_AND_5_WHEELBITMAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class WheelBitmap final {
+
+ public:
+  WheelBitmap() : base_(0), data_(nullptr), bytes_(0), mapped_(false) {}
+  WheelBitmap(const WheelBitmap &) = delete;
+  WheelBitmap &operator=(const WheelBitmap &) = delete;
+
+  // Empty set for numbers from [low, high]
+  void reset(long long low, long long high);
+
+  // Keep marked primes and make place for numbers up to high
+  void extend(long long high);
+
+  // n must be prime from range, bitmap mustn't be mapped (extend() copies it)
+  void set(long long n);
+
+  // n must be from range
+  bool test(long long n) const;
+
+  // Use bitmap of range from 0, which was saved from bits(). Memory must live until bitmap is changed.
+  void map(const uint8_t *bits, size_t bytes);
+
+  const uint8_t *bits() const;
+  size_t bytes() const;
+
+ private:
+  // Number of bit for every residue modulo 30, -1 for residues which aren't coprime with 30
+  static const int8_t wheelIndex_[30];
+
+  // Residue modulo 30 for every bit
+  static const uint8_t wheelOffsets_[8];
+
+  // First number of range rounded down to multiple of 30
+  long long base_;
+  std::vector<uint8_t> bits_;
+
+  // Reading goes through it, it points to bits_ or mapped memory
+  const uint8_t *data_;
+  size_t bytes_;
+  bool mapped_;
+};
+
+#endif //OOP_4_AND_5_WHEELBITMAP_H
@@ -14,6 +14,8 @@
 #include <iostream>
 #include <thread>
 #include <random>
+#include <algorithm>
+#include <iterator>
 #include <AtkinSieve/AtkinSieve.h>
 
 class AtkinFixture : public ::testing::Test {
@@ -123,4 +125,55 @@ TEST_F(AtkinFixture, RightDiffTest) {
       test_it++;
     }
   }
-}
\ No newline at end of file
+}
+
+TEST(AtkinParallel, SameAsOneThread) {
+  AtkinSieve single(1);
+  AtkinSieve parallel(4);
+
+  single.setPrimes(50000000);
+  parallel.setPrimes(50000000);
+
+  ASSERT_EQ(single.size(), parallel.size());
+  EXPECT_TRUE(std::equal(single.begin(), single.end(), parallel.begin()));
+
+  single.setPrimes(1000000000000ll - 20000000, 1000000000000ll);
+  parallel.setPrimes(1000000000000ll - 20000000, 1000000000000ll);
+
+  ASSERT_EQ(single.size(), parallel.size());
+  EXPECT_TRUE(std::equal(single.begin(), single.end(), parallel.begin()));
+}
+
+TEST(AtkinStorage, GapsSameAsVector) {
+  AtkinSieve vector(1);
+  AtkinSieve gaps(1, AtkinSieve::Storage::Gaps);
+
+  for (const long long limit: {3000000ll, 1000ll, 5000000ll}) {
+    vector.setPrimes(limit);
+    gaps.setPrimes(limit);
+
+    ASSERT_EQ(vector.size(), gaps.size());
+    EXPECT_TRUE(std::equal(vector.begin(), vector.end(), gaps.compactBegin()));
+    EXPECT_EQ(std::distance(gaps.compactBegin(), gaps.compactEnd()), gaps.size());
+    EXPECT_EQ(vector[vector.size() - 1], gaps[gaps.size() - 1]);
+  }
+
+  EXPECT_THROW(gaps.begin(), std::invalid_argument);
+  EXPECT_THROW(gaps.end(), std::invalid_argument);
+  EXPECT_THROW(vector.compactBegin(), std::invalid_argument);
+}
+
+TEST_F(AtkinFixture, ExtendAndShrinkTest) {
+  for (const unsigned int limit: {1000u, 30u, 5000000u, 100u, 3000000u, 7000000u}) {
+    auto test = genTest(limit);
+    atkinSieve->setPrimes(limit);
+
+    ASSERT_EQ(test.size(), atkinSieve->size());
+    EXPECT_TRUE(std::equal(test.begin(), test.end(), atkinSieve->begin()));
+  }
+
+  EXPECT_TRUE(atkinSieve->isPrime(59));
+  EXPECT_FALSE(atkinSieve->isPrime(6999999));
+  EXPECT_TRUE(atkinSieve->isPrime(6999997));
+  EXPECT_THROW(atkinSieve->isPrime(7000001), std::invalid_argument);
+}
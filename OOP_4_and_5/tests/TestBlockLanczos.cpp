@@ -0,0 +1,65 @@
+/**
+ * @file TestBlockLanczos.cpp
+ * Tests for block Lanczos algorithm.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include <BlockLanczos/BlockLanczos.h>
+
+namespace {
+
+  void generateMatrix(SparseMatrix &matrix, uint32_t cols, uint32_t weight) {
+    std::mt19937 mt(cols);
+
+    // Small rows are dense, like small primes of factor base
+    for (uint32_t j = 0; j < cols; ++j) {
+      std::vector<uint32_t> column;
+      for (uint32_t k = 0; k < weight; ++k) {
+        const uint64_t bound = uint64_t(1) << std::min(2 * k + 3, 32u);
+        std::uniform_int_distribution<uint32_t> dist(0, static_cast<uint32_t>(std::min<uint64_t>(matrix.rows() - 1, bound)));
+        column.emplace_back(dist(mt));
+      }
+      matrix.addColumn(column);
+    }
+  }
+
+  uint32_t checkNullspace(uint32_t rows, uint32_t cols, uint32_t threads) {
+    SparseMatrix matrix(rows, threads);
+    generateMatrix(matrix, cols, 20);
+
+    BlockLanczos lanczos(matrix);
+    std::vector<uint64_t> dependencies = lanczos.solve();
+    EXPECT_EQ(cols, dependencies.size());
+
+    std::vector<uint64_t> product;
+    matrix.multiply(dependencies, product);
+
+    for (const auto &i: product) {
+      EXPECT_EQ(0, i);
+    }
+
+    uint64_t nonzero = 0;
+    for (const auto &i: dependencies) {
+      nonzero |= i;
+    }
+
+    return static_cast<uint32_t>(__builtin_popcountll(nonzero));
+  }
+
+}
+
+TEST(BlockLanczos, SmallMatrix) {
+  EXPECT_LE(32, checkNullspace(500, 520, 1));
+}
+
+TEST(BlockLanczos, LargeMatrix) {
+  EXPECT_LE(32, checkNullspace(20000, 20030, 1));
+}
+
+TEST(BlockLanczos, ParallelMatrix) {
+  EXPECT_LE(32, checkNullspace(20000, 20030, 4));
+}
@@ -44,4 +44,69 @@ TEST(CalculateMod, Test3) {
 
 TEST(CalculateMod, Test4) {
   EXPECT_EQ(6, MathFunctions::mod(-15, -7));
-}
\ No newline at end of file
+}
+
+TEST(CalculatePowMod, LargeModulus) {
+  // (2^32)^2 = 2^64 = 59 (mod 2^64 - 59)
+  EXPECT_EQ(59u, MathFunctions::pow_mod(1ull << 32, 2, 18446744073709551557ull));
+  EXPECT_EQ(1u, MathFunctions::pow_mod(123456789, 18446744073709551556ull, 18446744073709551557ull));
+}
+
+TEST(CalculateMontgomery, Multiply) {
+  const uint64_t n = 18446744073709551557ull;
+  const MathFunctions::Montgomery mont(n);
+
+  const uint64_t x = 12345678901234567890ull;
+  const uint64_t y = 9876543210987654321ull;
+  const uint64_t product = mont.fromForm(mont.multiply(mont.toForm(x), mont.toForm(y)));
+  EXPECT_EQ(MathFunctions::mul_mod(x, y, n), product);
+  EXPECT_EQ(1u, mont.fromForm(mont.power(mont.toForm(x), n - 1)));
+}
+
+TEST(CalculateBarrett, Reduce) {
+  const MathFunctions::Barrett barrett(4294967291u);
+
+  EXPECT_EQ(18446744073709551615ull % 4294967291u, barrett.reduce(18446744073709551615ull));
+  EXPECT_EQ(4294967290ull * 4294967290ull % 4294967291u, barrett.multiply(4294967290u, 4294967290u));
+  EXPECT_EQ(1u, barrett.power(3, 4294967290ull));
+}
+
+TEST(CalculateSqrtMod, Batch) {
+  const mpz_class n("327816199778383421361088844849", 10);
+  const std::vector<uint32_t> primes = {2, 13, 101, 10009, 100049, 1000000009, 4294967291u};
+
+  std::vector<uint32_t> roots;
+  MathFunctions::sqrt_mod(n * n, primes, roots);
+
+  ASSERT_EQ(primes.size(), roots.size());
+  for (size_t i = 0; i < primes.size(); ++i) {
+    const auto expected = static_cast<uint32_t>(mpz_fdiv_ui(n.get_mpz_t(), primes[i]));
+    EXPECT_TRUE(roots[i] == expected || roots[i] == primes[i] - expected);
+  }
+}
+
+TEST(CalculateInverseMod, Batch) {
+  const std::vector<uint32_t> primes = {3, 7, 101, 4294967291u};
+
+  std::vector<uint32_t> inverses;
+  MathFunctions::inverse_mod(mpz_class(202), primes, inverses);
+
+  EXPECT_EQ(std::vector<uint32_t>({1, 6, 0, inverses[3]}), inverses);
+  EXPECT_EQ(1u, 202ull * inverses[3] % 4294967291u);
+}
+
+TEST(CalculateKnuthSchroeppel, Multiplier) {
+  std::vector<uint32_t> primes;
+  for (uint32_t p = 2; p < 1000; ++p) {
+    bool prime = true;
+    for (uint32_t d = 2; d * d <= p && prime; ++d)
+      prime = p % d != 0;
+    if (prime)
+      primes.emplace_back(p);
+  }
+
+  EXPECT_EQ(31u, MathFunctions::knuth_schroeppel(mpz_class("998244359987710471", 10), primes));
+  EXPECT_EQ(1u, MathFunctions::knuth_schroeppel(mpz_class("2305843009213693951", 10), primes));
+  EXPECT_EQ(13u, MathFunctions::knuth_schroeppel(
+      mpz_class("1000000000000000003000000000000000000000000000000000000021", 10), primes));
+}
@@ -0,0 +1,148 @@
+/**
+ * @file TestMatrix.cpp
+ * Tests for dense matrix over GF(2).
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 10.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <Matrix/Matrix.h>
+
+#include <random>
+
+namespace {
+
+  uint32_t rankOf(std::vector<std::vector<bool> > m) {
+    uint32_t rank = 0;
+    for (uint32_t j = 0; j < m[0].size() && rank < m.size(); ++j) {
+      uint32_t pivot = rank;
+      while (pivot < m.size() && !m[pivot][j])
+        ++pivot;
+      if (pivot == m.size())
+        continue;
+
+      std::swap(m[rank], m[pivot]);
+      for (uint32_t i = rank + 1; i < m.size(); ++i) {
+        if (m[i][j]) {
+          for (uint32_t k = j; k < m[i].size(); ++k)
+            m[i][k] = m[i][k] != m[rank][k];
+        }
+      }
+      ++rank;
+    }
+    return rank;
+  }
+
+  void checkReduce(uint32_t rows, uint32_t cols, double density) {
+    std::mt19937 random(rows + cols);
+    std::bernoulli_distribution bit(density);
+
+    Matrix M(rows, cols + 1);
+    std::vector<std::vector<bool> > copy(rows, std::vector<bool>(cols));
+    for (uint32_t i = 0; i < rows; ++i) {
+      for (uint32_t j = 0; j < cols; ++j) {
+        copy[i][j] = bit(random);
+        M(i, j) = copy[i][j];
+      }
+    }
+
+    M.reduce();
+
+    // Row echelon form with the same rank
+    uint32_t rank = 0;
+    int64_t lastLead = -1;
+    for (uint32_t i = 0; i < rows; ++i) {
+      int64_t lead = -1;
+      for (uint32_t j = 0; j < cols && lead < 0; ++j) {
+        if (M(i, j))
+          lead = j;
+      }
+
+      if (lead < 0) {
+        lastLead = cols;
+        continue;
+      }
+
+      EXPECT_GT(lead, lastLead);
+      lastLead = lead;
+      ++rank;
+    }
+    EXPECT_EQ(rankOf(copy), rank);
+
+    // Solution of reduced system is solution of original one
+    const std::vector<uint32_t> x = M.solve();
+    for (uint32_t i = 0; i < rows; ++i) {
+      uint32_t sum = 0;
+      for (uint32_t j = 0; j < cols; ++j)
+        sum ^= copy[i][j] & x[j];
+      EXPECT_EQ(0, sum);
+    }
+  }
+
+}
+
+TEST(Matrix, ReduceSmall) {
+  checkReduce(5, 7, 0.5);
+  checkReduce(40, 45, 0.5);
+}
+
+TEST(Matrix, ReduceDense) {
+  checkReduce(300, 310, 0.5);
+  checkReduce(700, 650, 0.3);
+}
+
+TEST(Matrix, ReduceSparse) {
+  checkReduce(1000, 1030, 0.01);
+}
+
+TEST(Matrix, Copy) {
+  Matrix M(3, 130);
+  M(2, 129) = true;
+  M(0, 1) = true;
+
+  Matrix copy(M);
+  M(2, 129).flip();
+
+  EXPECT_TRUE(copy(2, 129));
+  EXPECT_TRUE(copy(0, 1));
+  EXPECT_FALSE(copy(1, 0));
+  EXPECT_FALSE(M(2, 129));
+}
+
+TEST(Matrix, Nullspace) {
+  std::mt19937 random(7);
+  std::bernoulli_distribution bit(0.3);
+
+  const uint32_t rows = 200;
+  const uint32_t cols = 300;
+  Matrix M(rows, cols);
+  std::vector<std::vector<bool> > copy(rows, std::vector<bool>(cols));
+  for (uint32_t i = 0; i < rows; ++i) {
+    for (uint32_t j = 0; j < cols; ++j) {
+      copy[i][j] = bit(random);
+      M(i, j) = copy[i][j];
+    }
+  }
+
+  M.reduce();
+  const std::vector<Matrix::Block> x = M.nullspace();
+  ASSERT_EQ(cols, x.size());
+
+  for (uint32_t i = 0; i < rows; ++i) {
+    Matrix::Block sum = 0;
+    for (uint32_t j = 0; j < cols; ++j) {
+      if (copy[i][j])
+        sum ^= x[j];
+    }
+    EXPECT_EQ(0, sum);
+  }
+
+  // All 64 solutions are nonzero and independent, because every one has own free variable
+  std::vector<std::vector<bool> > solutions(64, std::vector<bool>(cols));
+  for (uint32_t k = 0; k < 64; ++k) {
+    for (uint32_t j = 0; j < cols; ++j)
+      solutions[k][j] = ((x[j] >> k) & 1) != 0;
+  }
+  EXPECT_EQ(64, rankOf(solutions));
+}
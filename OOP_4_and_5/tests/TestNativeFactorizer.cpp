@@ -0,0 +1,69 @@
+/**
+ * @file TestNativeFactorizer.cpp
+ * Tests for factorization of 64-bit numbers.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 11.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <random>
+#include <NativeFactorizer/NativeFactorizer.h>
+
+TEST(NativeFactorizer, IsPrime) {
+  EXPECT_FALSE(NativeFactorizer::is_prime(0));
+  EXPECT_FALSE(NativeFactorizer::is_prime(1));
+  EXPECT_TRUE(NativeFactorizer::is_prime(2));
+  EXPECT_TRUE(NativeFactorizer::is_prime(1000000007));
+  EXPECT_TRUE(NativeFactorizer::is_prime(18446744073709551557ull));
+
+  // Carmichael number and strong pseudoprimes to several bases
+  EXPECT_FALSE(NativeFactorizer::is_prime(561));
+  EXPECT_FALSE(NativeFactorizer::is_prime(3215031751ull));
+  EXPECT_FALSE(NativeFactorizer::is_prime(3825123056546413051ull));
+  EXPECT_FALSE(NativeFactorizer::is_prime(18446744073709551615ull));
+}
+
+TEST(NativeFactorizer, PollardBrent) {
+  const uint64_t n = 4294967291ull * 4294967279ull;
+  const uint64_t d = NativeFactorizer::pollard_brent(n);
+  EXPECT_TRUE(d == 4294967291ull || d == 4294967279ull);
+}
+
+TEST(NativeFactorizer, Squfof) {
+  const uint64_t n = 1000000007ull * 998244353ull;
+  const uint64_t d = NativeFactorizer::squfof(n);
+  EXPECT_TRUE(d == 1000000007ull || d == 998244353ull);
+
+  EXPECT_EQ(65537, NativeFactorizer::squfof(65537ull * 65537ull));
+}
+
+TEST(NativeFactorizer, Factorize) {
+  EXPECT_EQ(std::vector<uint64_t>({2, 2, 3, 5}), NativeFactorizer::factorize(60));
+  EXPECT_EQ(std::vector<uint64_t>({1000000007}), NativeFactorizer::factorize(1000000007));
+  EXPECT_EQ(std::vector<uint64_t>({3, 5, 17, 257, 641, 65537, 6700417}),
+            NativeFactorizer::factorize(18446744073709551615ull));
+  EXPECT_EQ(std::vector<uint64_t>({1009, 1009, 4294967279ull}),
+            NativeFactorizer::factorize(1009ull * 1009 * 4294967279ull));
+}
+
+TEST(NativeFactorizer, PollardBrentOtherConstants) {
+  const uint64_t n = 4294967291ull * 4294967279ull;
+  const uint64_t d = NativeFactorizer::pollard_brent(n, 100);
+  EXPECT_TRUE(d == 4294967291ull || d == 4294967279ull);
+}
+
+TEST(NativeFactorizer, FactorsArePrime) {
+  std::mt19937_64 mt(2017);
+
+  for (uint32_t i = 0; i < 2000; ++i) {
+    const uint64_t n = mt() | 1;
+    uint64_t product = 1;
+
+    for (const auto &factor: NativeFactorizer::factorize(n)) {
+      EXPECT_TRUE(NativeFactorizer::is_prime(factor)) << factor << " of " << n;
+      product *= factor;
+    }
+    EXPECT_EQ(n, product);
+  }
+}
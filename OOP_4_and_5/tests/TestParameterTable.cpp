@@ -0,0 +1,95 @@
+/**
+ * @file TestParameterTable.cpp
+ * Tests for table of sieve parameters.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 18.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <ParameterTable/ParameterTable.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+TEST(ParameterTable, ReadWrite) {
+  std::istringstream in("# comment\n"
+                        "\n"
+                        "20 100 16384 1.5 30 1\n"
+                        "  40 500 65536 2.5 50 2\n");
+
+  const auto rows = ParameterTable::read(in);
+  ASSERT_EQ(2, rows.size());
+  EXPECT_EQ(40u, rows[1].digits);
+  EXPECT_EQ(500u, rows[1].factorBaseSize);
+  EXPECT_DOUBLE_EQ(2.5, rows[1].thresholdFactor);
+  EXPECT_EQ(2u, rows[1].largePrimes);
+
+  std::stringstream out;
+  ParameterTable::write(out, rows);
+  const auto again = ParameterTable::read(out);
+  ASSERT_EQ(2, again.size());
+  EXPECT_EQ(100u, again[0].factorBaseSize);
+  EXPECT_EQ(65536u, again[1].halfInterval);
+}
+
+TEST(ParameterTable, WrongTable) {
+  std::istringstream shortRow("20 100 16384 1.5 30\n");
+  EXPECT_THROW(ParameterTable::read(shortRow), std::invalid_argument);
+
+  std::istringstream longRow("20 100 16384 1.5 30 1 7\n");
+  EXPECT_THROW(ParameterTable::read(longRow), std::invalid_argument);
+
+  std::istringstream unsorted("40 500 65536 2.5 50 2\n20 100 16384 1.5 30 1\n");
+  EXPECT_THROW(ParameterTable::read(unsorted), std::invalid_argument);
+
+  std::istringstream negative("20 -5 16384 1.5 30 1\n");
+  EXPECT_THROW(ParameterTable::read(negative), std::invalid_argument);
+
+  std::istringstream huge("20 100 16384 1.5 1000000 1\n");
+  EXPECT_THROW(ParameterTable::read(huge), std::invalid_argument);
+
+  std::istringstream empty("# nothing\n");
+  EXPECT_THROW(ParameterTable::read(empty), std::invalid_argument);
+
+  EXPECT_FALSE(ParameterTable::instance().load("there_is_no_such_file.txt"));
+
+  // Broken file doesn't change table
+  const char *fileName = "test_parameters.txt";
+  {
+    std::ofstream file(fileName);
+    file << "20 100 16384 1.5 thirty 1\n";
+  }
+
+  const auto before = ParameterTable::instance().rows();
+  EXPECT_THROW(ParameterTable::instance().load(fileName), std::invalid_argument);
+  EXPECT_EQ(before.size(), ParameterTable::instance().rows().size());
+  EXPECT_EQ(before.back().factorBaseSize, ParameterTable::instance().rows().back().factorBaseSize);
+
+  std::remove(fileName);
+}
+
+TEST(ParameterTable, Interpolation) {
+  auto &table = ParameterTable::instance();
+  const auto saved = table.rows();
+
+  table.setRows({{20, 100, 16384, 1.0, 30, 1}, {40, 500, 65536, 3.0, 50, 2}});
+
+  EXPECT_EQ(100u, table.get(10).factorBaseSize);
+  EXPECT_EQ(500u, table.get(90).factorBaseSize);
+
+  const auto middle = table.get(30);
+  EXPECT_EQ(30u, middle.digits);
+  EXPECT_EQ(300u, middle.factorBaseSize);
+  EXPECT_DOUBLE_EQ(2.0, middle.thresholdFactor);
+  EXPECT_EQ(16384u, middle.halfInterval);
+  EXPECT_EQ(1u, middle.largePrimes);
+
+  // Factor base decreases between rows
+  table.setRows({{10, 40, 16384, 1.0, 30, 1}, {14, 36, 16384, 1.0, 30, 1}});
+  EXPECT_EQ(37u, table.get(13).factorBaseSize);
+
+  table.setRows(saved);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file TestPartialRelations.cpp
+ * Tests for combining of partial relations.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 04.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <PartialRelations/PartialRelations.h>
+
+TEST(PartialRelations, SingleLargePrime) {
+  PartialRelations partials(mpz_class(1000003));
+  std::vector<Relation> full;
+
+  EXPECT_FALSE(partials.addRelation(Relation{5, {0, 1}, true}, 101, 1, full));
+  EXPECT_FALSE(partials.addRelation(Relation{7, {2}, false}, 103, 1, full));
+  EXPECT_TRUE(partials.addRelation(Relation{11, {1}, true}, 101, 1, full));
+
+  ASSERT_EQ(1, full.size());
+  EXPECT_EQ(55, full[0].y);
+  EXPECT_EQ(101, full[0].largeFactor);
+  EXPECT_EQ(3, full[0].factors.size());
+  EXPECT_FALSE(full[0].negative);
+}
+
+TEST(PartialRelations, DoubleLargePrime) {
+  PartialRelations partials(mpz_class(1000003));
+  std::vector<Relation> full;
+
+  EXPECT_FALSE(partials.addRelation(Relation{2, {0}, false}, 101, 103, full));
+  EXPECT_FALSE(partials.addRelation(Relation{3, {1}, true}, 103, 1, full));
+  EXPECT_TRUE(partials.addRelation(Relation{5, {2}, false}, 101, 1, full));
+
+  ASSERT_EQ(1, full.size());
+  EXPECT_EQ(30, full[0].y);
+  EXPECT_EQ(101 * 103, full[0].largeFactor);
+  EXPECT_EQ(3, full[0].factors.size());
+  EXPECT_TRUE(full[0].negative);
+}
@@ -0,0 +1,137 @@
+/**
+ * @file TestPrimeCache.cpp
+ * Tests for cache file of primes.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <AtkinSieve/AtkinSieve.h>
+#include <PrimeCache/PrimeCache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+  const char *cacheFile = "test_primes.cache";
+
+}
+
+TEST(PrimeCache, SaveLoadAndExtend) {
+  AtkinSieve original(1);
+  original.setPrimes(3000000);
+  ASSERT_TRUE(original.saveCache(cacheFile));
+
+  AtkinSieve loaded(1);
+  ASSERT_TRUE(loaded.loadCache(cacheFile));
+  EXPECT_EQ(3000000, loaded.limit());
+  ASSERT_EQ(original.size(), loaded.size());
+  EXPECT_TRUE(std::equal(original.begin(), original.end(), loaded.begin()));
+  EXPECT_TRUE(loaded.isPrime(2999999));
+  EXPECT_FALSE(loaded.isPrime(2999997));
+
+  original.setPrimes(5000000);
+  loaded.setPrimes(5000000);
+  ASSERT_EQ(original.size(), loaded.size());
+  EXPECT_TRUE(std::equal(original.begin(), original.end(), loaded.begin()));
+
+  loaded.setPrimes(1000);
+  EXPECT_EQ(168, loaded.size());
+
+  std::remove(cacheFile);
+}
+
+TEST(PrimeCache, WrongFile) {
+  EXPECT_TRUE(PrimeCache("no_such_file.cache").empty());
+
+  {
+    std::ofstream file(cacheFile, std::ios::binary);
+    file << "OOPPRIME but not a cache file";
+  }
+
+  EXPECT_TRUE(PrimeCache(cacheFile).empty());
+
+  AtkinSieve sieve(1);
+  EXPECT_FALSE(sieve.loadCache(cacheFile));
+
+  // Cut file is damaged
+  sieve.setPrimes(100000);
+  ASSERT_TRUE(sieve.saveCache(cacheFile));
+  std::string content;
+  {
+    std::ifstream file(cacheFile, std::ios::binary);
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  {
+    std::ofstream file(cacheFile, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size() - 8));
+  }
+  EXPECT_TRUE(PrimeCache(cacheFile).empty());
+
+  std::remove(cacheFile);
+}
+
+TEST(PrimeCache, ConcurrentWriters) {
+  std::vector<std::thread> writers;
+
+  // Every writer has own limit, file must be one of them after all renames
+  for (long long t = 1; t <= 4; ++t) {
+    writers.emplace_back([t]() {
+      const long long limit = 300000 * t;
+      const std::vector<uint8_t> bits(static_cast<size_t>(limit / 30 + 1), static_cast<uint8_t>(t));
+      for (uint32_t i = 0; i < 50; ++i) {
+        EXPECT_TRUE(PrimeCache::write(cacheFile, {limit, bits.data(), bits.size(), {nullptr, 0, nullptr, 0, 0, 0}}));
+      }
+    });
+  }
+
+  for (auto &writer: writers) {
+    writer.join();
+  }
+
+  const PrimeCache cache(cacheFile);
+  ASSERT_FALSE(cache.empty());
+
+  const long long t = cache.limit() / 300000;
+  EXPECT_EQ(300000 * t, cache.limit());
+  const PrimeCache::Table table = cache.table();
+  EXPECT_TRUE(std::all_of(table.bits, table.bits + table.bytes, [t](uint8_t b) { return b == t; }));
+
+  std::remove(cacheFile);
+}
+
+TEST(PrimeCache, LoadIsFasterThenSieve) {
+  const auto sieveStart = std::chrono::steady_clock::now();
+  AtkinSieve original(1);
+  original.setPrimes(50000000);
+  const auto sieveFinish = std::chrono::steady_clock::now();
+  ASSERT_TRUE(original.saveCache(cacheFile));
+
+  // Loading to gap list only maps file, nothing is decoded or copied
+  const auto loadStart = std::chrono::steady_clock::now();
+  AtkinSieve loaded(1, AtkinSieve::Storage::Gaps);
+  ASSERT_TRUE(loaded.loadCache(cacheFile));
+  const auto loadFinish = std::chrono::steady_clock::now();
+
+  const double sieveTime = std::chrono::duration<double>(sieveFinish - sieveStart).count();
+  const double loadTime = std::chrono::duration<double>(loadFinish - loadStart).count();
+  EXPECT_LT(100 * loadTime, sieveTime) << "sieve " << sieveTime << " s, load " << loadTime << " s";
+
+  ASSERT_EQ(original.size(), loaded.size());
+  EXPECT_EQ(original[original.size() - 1], loaded[loaded.size() - 1]);
+  EXPECT_EQ(original[1234567], loaded[1234567]);
+  EXPECT_TRUE(loaded.isPrime(49999991));
+  EXPECT_FALSE(loaded.isPrime(49999993));
+  EXPECT_TRUE(std::equal(original.begin(), original.end(), loaded.compactBegin()));
+  EXPECT_THROW(loaded.begin(), std::invalid_argument);
+
+  std::remove(cacheFile);
+}
@@ -0,0 +1,51 @@
+/**
+ * @file TestPrimeCounting.cpp
+ * Tests for prime counting function and n-th prime.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <PrimeCounting/PrimeCounting.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+
+TEST(PrimeCounting, KnownValues) {
+  EXPECT_EQ(0, PrimeCounting::prime_pi(0));
+  EXPECT_EQ(0, PrimeCounting::prime_pi(1));
+  EXPECT_EQ(1, PrimeCounting::prime_pi(2));
+  EXPECT_EQ(25, PrimeCounting::prime_pi(100));
+  EXPECT_EQ(78498, PrimeCounting::prime_pi(1000000));
+  EXPECT_EQ(50847534, PrimeCounting::prime_pi(1000000000));
+  EXPECT_EQ(4118054813ull, PrimeCounting::prime_pi(100000000000ull));
+  EXPECT_EQ(37607912018ull, PrimeCounting::prime_pi(1000000000000ull));
+}
+
+TEST(PrimeCounting, SameAsSieve) {
+  SegmentedSieve sieve(0, 20000000, 1u << 16);
+  std::vector<uint64_t> block;
+  uint64_t count = 0;
+
+  // Check pi at last number of every block and around primes
+  while (sieve.next(block)) {
+    count += block.size();
+    EXPECT_EQ(count, PrimeCounting::prime_pi(block.back()));
+    EXPECT_EQ(count - 1, PrimeCounting::prime_pi(block.back() - 1));
+  }
+}
+
+TEST(PrimeCounting, NthPrime) {
+  EXPECT_EQ(2, PrimeCounting::nth_prime(1));
+  EXPECT_EQ(3, PrimeCounting::nth_prime(2));
+  EXPECT_EQ(541, PrimeCounting::nth_prime(100));
+  EXPECT_EQ(999983, PrimeCounting::nth_prime(78498));
+  EXPECT_EQ(1000003, PrimeCounting::nth_prime(78499));
+  EXPECT_EQ(22801763489ull, PrimeCounting::nth_prime(1000000000));
+  EXPECT_THROW(PrimeCounting::nth_prime(0), std::invalid_argument);
+
+  for (uint64_t n = 1; n < 2000; n += 37) {
+    const uint64_t p = PrimeCounting::nth_prime(n);
+    EXPECT_EQ(n, PrimeCounting::prime_pi(p));
+    EXPECT_EQ(n - 1, PrimeCounting::prime_pi(p - 1));
+  }
+}
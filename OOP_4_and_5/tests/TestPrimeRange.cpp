@@ -0,0 +1,50 @@
+/**
+ * @file TestPrimeRange.cpp
+ * Tests for lazy sequence of primes from window.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 14.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <PrimeRange/PrimeRange.h>
+
+TEST(PrimeRange, SmallWindows) {
+  const std::vector<uint64_t> expected{2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+  const PrimeRange range(0, 30);
+  EXPECT_EQ(expected, std::vector<uint64_t>(range.begin(), range.end()));
+
+  const PrimeRange empty(24, 28);
+  EXPECT_TRUE(empty.begin() == empty.end());
+
+  const PrimeRange reversed(100, 10);
+  EXPECT_TRUE(reversed.begin() == reversed.end());
+}
+
+TEST(PrimeRange, HighWindow) {
+  const uint64_t low = 1000000000000000ull;
+  const uint64_t high = low + 200000;
+
+  std::vector<uint64_t> expected;
+  for (uint64_t n = low; n <= high; ++n) {
+    if (NativeFactorizer::is_prime(n))
+      expected.emplace_back(n);
+  }
+
+  std::vector<uint64_t> primes;
+  for (const auto &p: PrimeRange(low, high))
+    primes.emplace_back(p);
+
+  EXPECT_EQ(expected, primes);
+}
+
+TEST(PrimeRange, CopiesSharePosition) {
+  const PrimeRange range(10, 100);
+  auto it = range.begin();
+  auto copy = it;
+
+  ++copy;
+  EXPECT_EQ(13u, *it);
+  EXPECT_EQ(13u, *copy);
+}
@@ -0,0 +1,89 @@
+/**
+ * @file TestPrimeStorage.cpp
+ * Tests for compact storage of primes: gap list and wheel bitmap.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <PrimeGaps/PrimeGaps.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+#include <WheelBitmap/WheelBitmap.h>
+
+namespace {
+
+  std::vector<long long> primesFrom(uint64_t low, uint64_t high) {
+    SegmentedSieve sieve(low, high);
+    std::vector<long long> result;
+    std::vector<uint64_t> block;
+
+    while (sieve.next(block))
+      result.insert(result.end(), block.begin(), block.end());
+
+    return result;
+  }
+
+}
+
+TEST(PrimeGaps, IterateAndIndex) {
+  const auto primes = primesFrom(0, 1000000);
+  PrimeGaps gaps;
+  for (const auto &p: primes)
+    gaps.push_back(p);
+
+  ASSERT_EQ(primes.size(), gaps.size());
+  EXPECT_TRUE(std::equal(primes.begin(), primes.end(), gaps.begin()));
+
+  for (size_t i = 0; i < primes.size(); i += 997)
+    EXPECT_EQ(primes[i], gaps[i]);
+  EXPECT_EQ(primes.back(), gaps[gaps.size() - 1]);
+  EXPECT_THROW(gaps[gaps.size()], std::invalid_argument);
+
+  EXPECT_EQ(0, gaps.upperBound(1));
+  EXPECT_EQ(1, gaps.upperBound(2));
+  EXPECT_EQ(25, gaps.upperBound(100));
+  EXPECT_EQ(78498, gaps.upperBound(1000000));
+  EXPECT_EQ(101, *gaps.iteratorAt(25));
+}
+
+TEST(PrimeGaps, WideGaps) {
+  // Gap 1132 follows 1693182318746371
+  PrimeGaps gaps;
+  gaps.push_back(1693182318746371ll);
+  gaps.push_back(1693182318747503ll);
+  gaps.push_back(1693182318747523ll);
+
+  EXPECT_EQ(3, std::distance(gaps.begin(), gaps.end()));
+  EXPECT_EQ(1693182318747503ll, gaps[1]);
+  EXPECT_EQ(1693182318747523ll, gaps[2]);
+  EXPECT_THROW(gaps.push_back(1693182318747523ll), std::invalid_argument);
+}
+
+TEST(WheelBitmap, TestRange) {
+  const long long low = 1000000000000ll - 100000;
+  const long long high = 1000000000000ll;
+
+  WheelBitmap bitmap;
+  bitmap.reset(low, high - 50000);
+  for (const auto &p: primesFrom(low, high - 50000))
+    bitmap.set(p);
+
+  bitmap.extend(high);
+  for (const auto &p: primesFrom(high - 49999, high))
+    bitmap.set(p);
+
+  for (long long n = low; n <= high; ++n)
+    EXPECT_EQ(NativeFactorizer::is_prime(static_cast<uint64_t>(n)), bitmap.test(n)) << n;
+}
+
+TEST(WheelBitmap, SmallPrimes) {
+  WheelBitmap bitmap;
+  bitmap.reset(0, 100);
+  for (const auto &p: primesFrom(0, 100))
+    bitmap.set(p);
+
+  for (long long n = 0; n <= 100; ++n)
+    EXPECT_EQ(NativeFactorizer::is_prime(static_cast<uint64_t>(n)), bitmap.test(n)) << n;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file TestPrimeTable.cpp
+ * Tests for process-wide table of primes.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 13.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <PrimeTable/PrimeTable.h>
+
+#include <thread>
+
+TEST(PrimeTable, SmallLimit) {
+  const auto &primes = PrimeTable::instance().get(100);
+
+  ASSERT_GE(primes.limit(), 100u);
+  EXPECT_EQ(25, primes.upTo(100) - primes.begin());
+  EXPECT_EQ(2u, *primes.begin());
+  EXPECT_EQ(97u, *(primes.upTo(100) - 1));
+}
+
+TEST(PrimeTable, GrowKeepsOldSnapshots) {
+  const auto &small = PrimeTable::instance().get(1000);
+  const size_t smallSize = small.size();
+  const auto &large = PrimeTable::instance().get(small.limit() + 1);
+
+  EXPECT_GT(large.limit(), small.limit());
+  EXPECT_EQ(smallSize, small.size());
+  EXPECT_TRUE(std::equal(small.begin(), small.end(), large.begin()));
+
+  for (auto it = large.begin(); it != large.end(); ++it) {
+    EXPECT_TRUE(NativeFactorizer::is_prime(*it));
+  }
+}
+
+TEST(PrimeTable, ConcurrentReaders) {
+  std::vector<std::thread> threads;
+  std::vector<size_t> counts(8);
+
+  for (uint32_t t = 0; t < counts.size(); ++t) {
+    threads.emplace_back([t, &counts]() {
+      const auto &primes = PrimeTable::instance().get(1000000 + 200000 * t);
+      counts[t] = static_cast<size_t>(primes.upTo(1000000) - primes.begin());
+    });
+  }
+
+  for (auto &thread: threads) {
+    thread.join();
+  }
+
+  for (const auto &count: counts) {
+    EXPECT_EQ(78498u, count);
+  }
+}
@@ -0,0 +1,27 @@
+/**
+ * @file TestProductTree.cpp
+ * Tests for trial division by product tree.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <ProductTree/ProductTree.h>
+
+namespace {
+
+  const std::vector<uint32_t> primes{2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47};
+
+}
+
+TEST(ProductTree, SmallestDivisor) {
+  const ProductTree tree(primes);
+
+  EXPECT_EQ(0u, tree.smallestDivisor(mpz_class(53 * 59)));
+  EXPECT_EQ(41u, tree.smallestDivisor(mpz_class(41 * 43 * 1009)));
+  EXPECT_EQ(3u, tree.smallestDivisor(mpz_class(3000000021ul) * 47));
+  EXPECT_EQ(2u, tree.smallestDivisor(mpz_class(2 * 2 * 2 * 7 * 47 * 47) * 1000003));
+  EXPECT_EQ(47u, tree.smallestDivisor(mpz_class(47) * 1000003));
+  EXPECT_EQ(0u, tree.smallestDivisor(mpz_class(1000003)));
+}
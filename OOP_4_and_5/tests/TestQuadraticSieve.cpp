@@ -25,6 +25,16 @@ class QuadraticSieveTest : public ::testing::Test {
     return k.get_ui();
   }
 
+  // Factor of num must be proper divider, not 1 or num
+  void expectProperDivider(const mpz_class &num) {
+    const mpz_class k = qs.factorNumber(num);
+    std::cout << k.get_str(10) << '\n';
+
+    EXPECT_LT(1, k);
+    EXPECT_LT(k, num);
+    EXPECT_EQ(0, mpz_class(num % k));
+  }
+
  protected:
   virtual void SetUp() final {  }
 
@@ -109,3 +119,36 @@ TEST_F(QuadraticSieveTest, TestCreateFactorBase12) {
   EXPECT_EQ(0, simpleTest(num));
 }
 
+TEST_F(QuadraticSieveTest, TestSelfInitializing1) {
+  mpz_class num = mpz_class("327816199778383421361088844849", 10);
+
+  expectProperDivider(num);
+}
+
+TEST_F(QuadraticSieveTest, TestSelfInitializing2) {
+  mpz_class num = mpz_class("4669341920934802928950557812652374879233", 10);
+
+  expectProperDivider(num);
+}
+
+// Knuth-Schroeppel multiplier of these numbers isn't 1, factor must divide N, not kN
+TEST_F(QuadraticSieveTest, TestMultiplierClassic) {
+  // k = 31
+  mpz_class num = mpz_class("998244359987710471", 10);
+
+  expectProperDivider(num);
+}
+
+TEST_F(QuadraticSieveTest, TestMultiplierSelfInitializing1) {
+  // k = 29
+  mpz_class num = mpz_class("52835099256096840135405961901", 10);
+
+  expectProperDivider(num);
+}
+
+TEST_F(QuadraticSieveTest, TestMultiplierSelfInitializing2) {
+  // k = 13
+  mpz_class num = mpz_class("1000000000000000003000000000000000000000000000000000000021", 10);
+
+  expectProperDivider(num);
+}
@@ -0,0 +1,71 @@
+/**
+ * @file TestRelationCollector.cpp
+ * Tests for collecting relations from many threads.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 17.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <RelationCollector/RelationCollector.h>
+
+#include <set>
+#include <thread>
+
+TEST(RelationCollector, ManyThreads) {
+  const uint32_t threads = 4;
+  const uint32_t batches = 1000;
+
+  RelationCollector collector;
+  PartialRelations partials(mpz_class(1000003));
+  std::vector<Relation> relations;
+
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&collector, t]() {
+      for (uint32_t i = 0; i < batches; ++i) {
+        RelationCollector::Batch batch;
+        batch.relations.push_back(Relation{t * batches + i, {t}, false});
+        collector.push(std::move(batch));
+      }
+    });
+  }
+
+  // Collector is drained while workers are pushing
+  while (relations.size() < threads * batches)
+    collector.drain(partials, relations);
+
+  for (auto &worker: workers)
+    worker.join();
+
+  collector.drain(partials, relations);
+  ASSERT_EQ(threads * batches, relations.size());
+
+  std::set<mpz_class> ys;
+  for (const auto &relation: relations)
+    ys.insert(relation.y);
+  EXPECT_EQ(threads * batches, ys.size());
+}
+
+TEST(RelationCollector, PartialsOfDifferentBatches) {
+  RelationCollector collector;
+  PartialRelations partials(mpz_class(1000003));
+  std::vector<Relation> relations;
+
+  RelationCollector::Batch first;
+  first.partials.push_back(PartialRelation{Relation{5, {0, 1}, true}, 101, 1});
+  collector.push(std::move(first));
+
+  RelationCollector::Batch second;
+  second.partials.push_back(PartialRelation{Relation{11, {1}, true}, 101, 1});
+  collector.push(std::move(second));
+
+  EXPECT_FALSE(collector.stopped());
+  collector.drain(partials, relations);
+  collector.stop();
+  EXPECT_TRUE(collector.stopped());
+
+  ASSERT_EQ(1, relations.size());
+  EXPECT_EQ(55, relations[0].y);
+  EXPECT_EQ(101, relations[0].largeFactor);
+}
@@ -0,0 +1,60 @@
+/**
+ * @file TestRelationFilter.cpp
+ * Tests for filtering of relations before building of matrix.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 09.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <RelationFilter/RelationFilter.h>
+
+TEST(RelationFilter, Singletons) {
+  // Prime 3 is only in relation 2, after its removal prime 2 is only in relation 3
+  const std::vector<Relation> relations = {
+      Relation{1, {0, 1}, true},
+      Relation{2, {0, 1, 1, 1}, true},
+      Relation{3, {3, 2}, true},
+      Relation{4, {2, 4, 4}, false},
+  };
+
+  RelationFilter filter(relations, 5);
+  filter.filter(0);
+
+  ASSERT_EQ(2, filter.cols());
+  EXPECT_EQ(0, filter.relationIndex(0));
+  EXPECT_EQ(1, filter.relationIndex(1));
+
+  // Rows 0, 1 and sign row are left
+  EXPECT_EQ(3, filter.rows());
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}), filter.column(0));
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 2}), filter.column(1));
+}
+
+TEST(RelationFilter, Cliques) {
+  // Relations 0 - 3 are linked by primes 3, 4, 5 with weight 2
+  const std::vector<Relation> relations = {
+      Relation{1, {0, 3}, false},
+      Relation{2, {1, 3, 4}, false},
+      Relation{3, {0, 4, 5}, false},
+      Relation{4, {1, 5}, false},
+      Relation{5, {0, 1}, false},
+      Relation{6, {0, 2}, false},
+      Relation{7, {1, 2}, false},
+      Relation{8, {0, 1, 2}, false},
+  };
+
+  RelationFilter full(relations, 6);
+  full.filter(100);
+  EXPECT_EQ(8, full.cols());
+  EXPECT_EQ(6, full.rows());
+
+  RelationFilter filter(relations, 6);
+  filter.filter(1);
+
+  EXPECT_EQ(4, filter.cols());
+  EXPECT_EQ(3, filter.rows());
+  for (uint32_t j = 0; j < filter.cols(); ++j) {
+    EXPECT_LE(4, filter.relationIndex(j));
+  }
+}
@@ -0,0 +1,97 @@
+/**
+ * @file TestSegmentedSieve.cpp
+ * Tests for segmented sieve of Eratosthenes.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 12.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <AtkinSieve/AtkinSieve.h>
+#include <NativeFactorizer/NativeFactorizer.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+
+namespace {
+
+  std::vector<uint64_t> simpleSieve(uint64_t low, uint64_t high) {
+    std::vector<char> prime(high + 1, true);
+    std::vector<uint64_t> result;
+
+    for (uint64_t i = 2; i <= high; ++i) {
+      if (!prime[i])
+        continue;
+
+      if (i >= low)
+        result.emplace_back(i);
+
+      for (uint64_t j = i * i; j <= high; j += i)
+        prime[j] = false;
+    }
+
+    return result;
+  }
+
+  std::vector<uint64_t> allPrimes(SegmentedSieve &sieve) {
+    std::vector<uint64_t> result;
+    std::vector<uint64_t> block;
+
+    while (sieve.next(block))
+      result.insert(result.end(), block.begin(), block.end());
+
+    return result;
+  }
+
+}
+
+TEST(SegmentedSieve, SmallRanges) {
+  for (uint64_t low = 0; low < 40; ++low) {
+    for (uint64_t high = low; high < 120; high += 7) {
+      SegmentedSieve sieve(low, high, 4);
+      EXPECT_EQ(simpleSieve(low, high), allPrimes(sieve)) << low << ' ' << high;
+    }
+  }
+}
+
+TEST(SegmentedSieve, ManyBlocks) {
+  SegmentedSieve sieve(1000, 3000000, 1000);
+  EXPECT_EQ(simpleSieve(1000, 3000000), allPrimes(sieve));
+}
+
+TEST(SegmentedSieve, NearTrillion) {
+  const uint64_t low = 1000000000000ull - 100000;
+  const uint64_t high = 1000000000000ull;
+
+  SegmentedSieve sieve(low, high);
+  const auto primes = allPrimes(sieve);
+
+  std::vector<uint64_t> expected;
+  for (uint64_t n = low; n <= high; ++n) {
+    if (NativeFactorizer::is_prime(n))
+      expected.emplace_back(n);
+  }
+
+  EXPECT_EQ(expected, primes);
+}
+
+TEST(SegmentedSieve, AtkinSegmentedMode) {
+  AtkinSieve atkinSieve;
+  atkinSieve.setPrimes(20000000);
+
+  const auto expected = simpleSieve(0, 20000000);
+  ASSERT_EQ(expected.size(), atkinSieve.size());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), atkinSieve.begin()));
+
+  EXPECT_TRUE(atkinSieve.isPrime(19999999));
+  EXPECT_FALSE(atkinSieve.isPrime(19999997));
+  EXPECT_THROW(atkinSieve.isPrime(20000001), std::invalid_argument);
+}
+
+TEST(SegmentedSieve, AtkinRange) {
+  AtkinSieve atkinSieve;
+  atkinSieve.setPrimes(1000000000000ll - 1000, 1000000000000ll);
+
+  EXPECT_EQ(1000000000000ll - 11, *(atkinSieve.end() - 1));
+  EXPECT_TRUE(atkinSieve.isPrime(1000000000000ll - 11));
+  EXPECT_FALSE(atkinSieve.isPrime(1000000000000ll - 10));
+  EXPECT_THROW(atkinSieve.isPrime(100), std::invalid_argument);
+}
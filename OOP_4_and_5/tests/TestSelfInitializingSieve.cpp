@@ -0,0 +1,140 @@
+/**
+ * @file TestSelfInitializingSieve.cpp
+ * Tests for relations of self-initializing sieve.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 16.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <SelfInitializingSieve/SelfInitializingSieve.h>
+#include <PrimeTable/PrimeTable.h>
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+
+namespace {
+
+  std::vector<uint32_t> factorBase(const mpz_class &n, size_t size) {
+    const auto &primes = PrimeTable::instance().get(100000);
+    std::vector<uint32_t> result;
+
+    for (auto it = primes.begin(); it != primes.end() && result.size() < size; ++it) {
+      if (*it == 2 || mpz_legendre(n.get_mpz_t(), mpz_class(*it).get_mpz_t()) != -1)
+        result.emplace_back(*it);
+    }
+
+    return result;
+  }
+
+  // Y^2 = (-1)^negative * (product of factors) * largeFactor^2 * rest (mod N)
+  bool isValid(const mpz_class &n, const std::vector<uint32_t> &base, const Relation &relation,
+               const mpz_class &rest = 1) {
+    mpz_class right = relation.negative ? -rest : rest;
+    for (const auto &k: relation.factors)
+      right *= base[k];
+    right *= relation.largeFactor * relation.largeFactor;
+
+    const mpz_class left = relation.y * relation.y;
+    return mpz_congruent_p(left.get_mpz_t(), right.get_mpz_t(), n.get_mpz_t()) != 0;
+  }
+
+}
+
+TEST(SelfInitializingSieve, RelationsForBlockSizes) {
+  const mpz_class n("1000000000000000003000000000000000000000000000000000000021", 10);
+  const auto parameters = SelfInitializingSieve::getParameters(n);
+  const auto base = factorBase(n, parameters.factorBaseSize);
+
+  // The last block size is larger then interval, so there are no large primes
+  for (uint32_t blockSize: {1u << 12, 1u << 15, 1u << 20}) {
+    SelfInitializingSieve sieve(n, base, parameters, blockSize);
+    std::vector<Relation> relations;
+    std::vector<PartialRelation> partials;
+
+    while (relations.size() < 50)
+      sieve.sievePolynomial(relations, partials);
+
+    for (const auto &relation: relations)
+      EXPECT_TRUE(isValid(n, base, relation));
+
+    for (const auto &partial: partials)
+      EXPECT_TRUE(isValid(n, base, partial.relation, mpz_class(partial.firstPrime) * partial.secondPrime));
+  }
+}
+
+TEST(SelfInitializingSieve, WorkersHaveDifferentPolynomials) {
+  const mpz_class n("1000000000000000003000000000000000000000000000000000000021", 10);
+  const auto parameters = SelfInitializingSieve::getParameters(n);
+  const auto base = factorBase(n, parameters.factorBaseSize);
+
+  std::set<mpz_class> ys;
+  size_t count = 0;
+
+  for (uint32_t worker = 0; worker < 2; ++worker) {
+    SelfInitializingSieve sieve(n, base, parameters);
+    sieve.setWorker(worker, 2);
+
+    std::vector<Relation> relations;
+    std::vector<PartialRelation> partials;
+    while (relations.size() < 50)
+      sieve.sievePolynomial(relations, partials);
+
+    for (const auto &relation: relations)
+      ys.insert(relation.y);
+    count += relations.size();
+  }
+
+  EXPECT_EQ(count, ys.size());
+}
+
+// Factors of 'a' can't be taken from such base, sieve must stop instead of endless search
+TEST(SelfInitializingSieve, TinyFactorBase) {
+  const mpz_class n("1000000000000000003000000000000000000000000000000000000021", 10);
+  const auto parameters = SelfInitializingSieve::getParameters(n);
+  const auto base = factorBase(n, 12);
+
+  SelfInitializingSieve sieve(n, base, parameters);
+  std::vector<Relation> relations;
+  std::vector<PartialRelation> partials;
+
+  EXPECT_THROW(sieve.sievePolynomial(relations, partials), std::invalid_argument);
+}
+
+// Knuth-Schroeppel multiplier of this number is 3: Q(x) of every third x has one factor 3,
+// it must be in full relations, not a large prime of partial ones.
+// Prime 37 of other multiplier is sieved with its single root.
+TEST(SelfInitializingSieve, PrimeOfMultiplier) {
+  const mpz_class n("662264278713717320710840707929833824283", 10);
+  const auto parameters = SelfInitializingSieve::getParameters(n);
+
+  for (const uint32_t k: {3u, 37u}) {
+    const mpz_class kn = k * n;
+    const auto base = factorBase(kn, parameters.factorBaseSize);
+    const auto index = static_cast<uint32_t>(std::find(base.begin(), base.end(), k) - base.begin());
+    ASSERT_NE(base.size(), index);
+
+    SelfInitializingSieve sieve(kn, base, parameters);
+    std::vector<Relation> relations;
+    std::vector<PartialRelation> partials;
+
+    while (relations.size() < 100)
+      sieve.sievePolynomial(relations, partials);
+
+    size_t withK = 0;
+    for (const auto &relation: relations) {
+      EXPECT_TRUE(isValid(kn, base, relation));
+      if (std::count(relation.factors.begin(), relation.factors.end(), index) != 0)
+        ++withK;
+    }
+    EXPECT_LT(0u, withK);
+    if (k == 3)
+      EXPECT_LT(relations.size() / 5, withK);
+
+    for (const auto &partial: partials) {
+      EXPECT_LT(base.back(), partial.firstPrime);
+      EXPECT_TRUE(partial.secondPrime == 1 || partial.secondPrime > base.back());
+    }
+  }
+}
@@ -0,0 +1,84 @@
+/**
+ * @file TestSieveEngine.cpp
+ * Tests for sieve engines and bucket sieve.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 15.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <BucketSieve/BucketSieve.h>
+#include <SegmentedSieve/SegmentedSieve.h>
+#include <SieveEngine/SieveEngine.h>
+
+namespace {
+
+  const SieveEngine::Kind kinds[] = {SieveEngine::Kind::Atkin, SieveEngine::Kind::Eratosthenes,
+                                     SieveEngine::Kind::Bucket};
+
+  std::vector<uint64_t> reference(uint64_t low, uint64_t high) {
+    SegmentedSieve sieve(low, high);
+    std::vector<uint64_t> result;
+    std::vector<uint64_t> block;
+
+    while (sieve.next(block))
+      result.insert(result.end(), block.begin(), block.end());
+
+    return result;
+  }
+
+}
+
+TEST(SieveEngine, AllEnginesFromZero) {
+  for (const uint64_t high: {0ull, 1ull, 2ull, 3ull, 10ull, 60ull, 1000ull, 123457ull, 3000000ull}) {
+    const auto expected = reference(0, high);
+
+    for (const auto &kind: kinds) {
+      const auto engine = SieveEngine::create(kind);
+      std::vector<uint64_t> primes;
+      engine->sieve(0, high, primes);
+      EXPECT_EQ(expected, primes) << engine->name() << ' ' << high;
+    }
+  }
+}
+
+TEST(SieveEngine, AllEnginesWindows) {
+  for (const uint64_t low: {7ull, 1000ull, 999983ull, 50000000ull}) {
+    const uint64_t high = low + 1000000;
+    const auto expected = reference(low, high);
+
+    for (const auto &kind: kinds) {
+      const auto engine = SieveEngine::create(kind);
+      std::vector<uint64_t> primes;
+      engine->sieve(low, high, primes);
+      EXPECT_EQ(expected, primes) << engine->name() << ' ' << low;
+    }
+  }
+}
+
+TEST(SieveEngine, Select) {
+  EXPECT_EQ(SieveEngine::Kind::Atkin, SieveEngine::select(0, 1000));
+  EXPECT_NE(SieveEngine::Kind::Atkin, SieveEngine::select(1000, 2000));
+  EXPECT_NE(SieveEngine::Kind::Atkin, SieveEngine::select(0, 1ull << 30));
+}
+
+TEST(BucketSieve, SmallBlocksHighWindow) {
+  // Most of sieving primes are larger then block, some multiples are far after window start
+  const uint64_t low = 1000000000000ull;
+  const uint64_t high = low + 3000000;
+
+  BucketSieve sieve(low, high, 1024);
+  std::vector<uint64_t> primes;
+  std::vector<uint64_t> block;
+  while (sieve.next(block))
+    primes.insert(primes.end(), block.begin(), block.end());
+
+  EXPECT_EQ(reference(low, high), primes);
+
+  BucketSieve fromZero(0, 5000000, 256);
+  primes.clear();
+  while (fromZero.next(block))
+    primes.insert(primes.end(), block.begin(), block.end());
+
+  EXPECT_EQ(reference(0, 5000000), primes);
+}
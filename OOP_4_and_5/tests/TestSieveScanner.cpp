@@ -0,0 +1,34 @@
+/**
+ * @file TestSieveScanner.cpp
+ * Tests for scanning of byte sieve array.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 16.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <SieveScanner/SieveScanner.h>
+
+TEST(SieveScanner, Values) {
+  EXPECT_EQ(SieveScanner::scaled_log(2), 1);
+  EXPECT_EQ(SieveScanner::scaled_log(1000), 10);
+  EXPECT_EQ(SieveScanner::initial_value(20), 0x80 - 20);
+  EXPECT_EQ(SieveScanner::initial_value(300), 0);
+}
+
+TEST(SieveScanner, FindCandidates) {
+  // Size isn't multiple of block, so every branch of scanner is used
+  std::vector<uint8_t> sieve(1000 + 37, 0x7f);
+  std::vector<uint32_t> expected = {0, 5, 31, 32, 63, 500, 991, 1000, 1031, 1036};
+
+  for (const auto &i: expected)
+    sieve[i] = static_cast<uint8_t>(0x80 + i % 100);
+
+  std::vector<uint32_t> positions;
+  SieveScanner::find_candidates(sieve, positions);
+  EXPECT_EQ(positions, expected);
+
+  positions.clear();
+  SieveScanner::find_candidates(std::vector<uint8_t>(100, 0), positions);
+  EXPECT_TRUE(positions.empty());
+}
@@ -0,0 +1,48 @@
+/**
+ * @file TestThreadPool.cpp
+ * Tests for pool of threads.
+ *
+ * @author Anton Klochkov (tklochkov@gmail.com)
+ * @date 07.12.2017
+ * @version 1.0
+ */
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <ThreadPool/ThreadPool.h>
+
+TEST(ThreadPool, AllPartsAreRun) {
+  ThreadPool pool(4);
+  std::vector<uint32_t> counts(4, 0);
+
+  // The same threads are reused by every task
+  for (uint32_t task = 0; task < 1000; ++task) {
+    pool.run(1 + task % 4, [&](uint32_t index) { ++counts[index]; });
+  }
+
+  EXPECT_EQ(1000, counts[0]);
+  EXPECT_EQ(750, counts[1]);
+  EXPECT_EQ(500, counts[2]);
+  EXPECT_EQ(250, counts[3]);
+}
+
+TEST(ThreadPool, ExceptionIsThrownAgain) {
+  ThreadPool pool(3);
+  std::atomic<uint32_t> finished(0);
+
+  EXPECT_THROW(pool.run(3, [&](uint32_t index) {
+    if (index == 2)
+      throw std::runtime_error("part failed");
+    ++finished;
+  }), std::runtime_error);
+  EXPECT_EQ(2, finished.load());
+
+  pool.run(3, [&](uint32_t) { ++finished; });
+  EXPECT_EQ(5, finished.load());
+}
+
+TEST(ThreadPool, TooManyParts) {
+  ThreadPool pool(2);
+
+  EXPECT_THROW(pool.run(3, [](uint32_t) {}), std::invalid_argument);
+}